@@ -293,6 +293,7 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram (Sound me, double pitchFloor, dou
 
 		autoMelderProgress progress (U"Cepstrogram analysis");
 
+		autoSound_to_Spectrum_reuseFourierTable reuse;
 		for (integer iframe = 1; iframe <= nFrames; iframe++) {
 			double t = Sampled_indexToX (thee.get(), iframe);
 			Sound_into_Sound (sound.get(), sframe.get(), t - windowDuration / 2);
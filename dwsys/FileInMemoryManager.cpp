@@ -131,6 +131,18 @@ autoFileInMemorySet FileInMemoryManager_extractFiles (FileInMemoryManager me, kM
 	return FileInMemorySet_extractFiles (my files.get(), which, criterion);
 }
 
+/*
+	The FILE * is the index of the file in my files, so the stream can be resolved in constant time.
+	Returns nullptr if the file is not open.
+*/
+static FileInMemory _FileInMemoryManager_getOpenFile (FileInMemoryManager me, FILE *stream) {
+	integer filesIndex = reinterpret_cast<integer> (stream);
+	Melder_require (filesIndex > 0 && filesIndex <= my files -> size, U": Invalid file index: ", filesIndex);
+
+	FileInMemory fim = static_cast<FileInMemory> (my files -> at [filesIndex]);
+	return fim -> d_isOpen ? fim : nullptr;
+}
+
 static integer _FileInMemoryManager_getIndexInOpenFiles (FileInMemoryManager me, FILE *stream) {
 	integer filesIndex = reinterpret_cast<integer> (stream);
 	Melder_require (filesIndex > 0 && filesIndex <= my files -> size, U": Invalid file index: ", filesIndex);
@@ -193,11 +205,11 @@ FILE *FileInMemoryManager_fopen (FileInMemoryManager me, const char *filename, c
 			index = FileInMemorySet_lookUp (my files.get(), Melder_peek8to32(filename));
 			if (index > 0) {
 				FileInMemory fim = (FileInMemory) my files -> at [index];
-				if (fim -> d_position == 0) { // not open
+				if (! fim -> d_isOpen) {
 					my openFiles -> addItem_ref (fim);
-				} else { // reset position
-					fim -> d_position = 0;
+					fim -> d_isOpen = true;
 				}
+				fim -> d_position = 0; fim -> d_errno = 0; fim -> ungetChar = -1;
 			} else {
 				// file does not exist, set error condition?
 			}
@@ -231,9 +243,8 @@ FILE *FileInMemoryManager_fopen (FileInMemoryManager me, const char *filename, c
 	none
 */
 void FileInMemoryManager_rewind (FileInMemoryManager me, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
-	if (openFilesIndex > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+	if (fim) {
 		fim -> d_position = 0; fim -> d_errno = 0;  fim -> ungetChar = -1;
 	}
 }
@@ -260,11 +271,14 @@ void FileInMemoryManager_rewind (FileInMemoryManager me, FILE *stream) {
 	On failure, EOF is returned.
 */
 int FileInMemoryManager_fclose (FileInMemoryManager me, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
-	if (openFilesIndex > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+	if (fim) {
 		fim -> d_position = 0; fim -> d_errno = 0;  fim -> ungetChar = -1;
-		my openFiles -> removeItem (openFilesIndex);
+		fim -> d_isOpen = false;
+		integer openFilesIndex = FileInMemorySet_lookUp (my openFiles.get(), fim -> d_path);
+		if (openFilesIndex > 0) {
+			my openFiles -> removeItem (openFilesIndex);
+		}
 	}
 	return my errorNumber = 0; // always ok
 }
@@ -293,10 +307,9 @@ int FileInMemoryManager_fclose (FileInMemoryManager me, FILE *stream) {
 	Otherwise, zero is returned.
 */
 int FileInMemoryManager_feof (FileInMemoryManager me, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	int eof = 0;
-	if (openFilesIndex > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		if (fim -> d_position >= fim -> d_numberOfBytes) {
 			eof = 1;
 		}
@@ -343,10 +356,9 @@ int FileInMemoryManager_feof (FileInMemoryManager me, FILE *stream) {
 	If a read or write error occurs, the error indicator (ferror) is set.
 */
 int FileInMemoryManager_fseek (FileInMemoryManager me, FILE *stream, integer offset, int origin) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	int errval = EBADF;
-	if (openFilesIndex > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		integer newPosition = 0;
 		if (origin == SEEK_SET) {
 			newPosition = offset;
@@ -389,11 +401,10 @@ int FileInMemoryManager_fseek (FileInMemoryManager me, FILE *stream, integer off
 	On failure, -1L is returned, and errno is set to a system-specific positive value.
 */
 integer FileInMemoryManager_ftell (FileInMemoryManager me, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	/* int errval = EBADF; */
 	integer currentPosition = -1L;
-	if (openFilesIndex > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		currentPosition = fim -> d_position;
 	}
 	return currentPosition;
@@ -429,12 +440,11 @@ integer FileInMemoryManager_ftell (FileInMemoryManager me, FILE *stream) {
 	If a read error occurs, the error indicator (ferror) is set and a null pointer is also returned (but the contents pointed by str may have changed). 
  */
 char *FileInMemoryManager_fgets (FileInMemoryManager me, char *str, int num, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	char *result = nullptr;
 	
-	Melder_require (openFilesIndex > 0, U": File should be open.");
+	Melder_require (fim, U": File should be open.");
 
-	FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
 	integer startPos = fim -> d_position;
 	if (startPos < fim -> d_numberOfBytes) {
 		integer i = 0, endPos = startPos + num;
@@ -485,9 +495,18 @@ char *FileInMemoryManager_fgets (FileInMemoryManager me, char *str, int num, FIL
 	If some other reading error happens, the function also returns EOF, but sets its error indicator (ferror) instead.
 */
 int FileInMemoryManager_fgetc (FileInMemoryManager me, FILE *stream) {
-	char str[4];
-	(void) FileInMemoryManager_fgets (me, str, 1, stream);
-	return FileInMemoryManager_feof (me, stream) ? EOF : static_cast<int> (*str);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+	
+	Melder_require (fim, U": File should be open.");
+
+	if (fim -> d_position >= fim -> d_numberOfBytes) {
+		fim -> d_errno = EOF;
+		return EOF;
+	}
+	int character = fim -> ungetChar >= 0 ? fim -> ungetChar : static_cast<int> (fim -> d_data [fim -> d_position]);
+	fim -> ungetChar = -1;
+	fim -> d_position ++;
+	return character;
 }
 
 /*
@@ -521,15 +540,14 @@ int FileInMemoryManager_fgetc (FileInMemoryManager me, FILE *stream) {
 	size_t is an unsigned integral type. 
 */
 size_t FileInMemoryManager_fread (FileInMemoryManager me, void *ptr, size_t size, size_t count, FILE *stream) {
-	integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	
-	Melder_require (openFilesIndex > 0 && size > 0 && count > 0, U": File should be open.");
+	Melder_require (fim && size > 0 && count > 0, U": File should be open.");
 	
-	FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
 	size_t result = 0;
 	integer startPos = fim -> d_position;
 	if (startPos < fim -> d_numberOfBytes) {
-		integer i = 0, endPos = startPos + count * size;
+		integer endPos = startPos + count * size;
 		
 		if (endPos > fim -> d_numberOfBytes) {
 			count = (fim -> d_numberOfBytes - startPos) / size;
@@ -537,11 +555,8 @@ size_t FileInMemoryManager_fread (FileInMemoryManager me, void *ptr, size_t size
 			fim -> d_errno = EOF;
 		}
 		integer numberOfBytes = count * size;
-		const unsigned char * p = fim -> d_data + fim -> d_position;
-		char * str = static_cast<char *> (ptr);
-		while (i < numberOfBytes) {
-			str [i ++] = *p ++;
-		}
+		memcpy (ptr, fim -> d_data + startPos, numberOfBytes);
+		fim -> ungetChar = -1;
 		fim -> d_position = endPos;
 	}
 	result = count;
@@ -584,9 +599,8 @@ size_t FileInMemoryManager_fread (FileInMemoryManager me, void *ptr, size_t size
 int FileInMemoryManager_ungetc (FileInMemoryManager me, int character, FILE * stream) {
 	int result = EOF;
 	if (character != EOF) {
-		integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
-		if (openFilesIndex > 0) {
-			FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+		FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+		if (fim) {
 			-- (fim -> d_position);
 			result = fim -> ungetChar = character;
 		}
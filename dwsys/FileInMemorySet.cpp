@@ -193,16 +193,30 @@ integer FileInMemorySet_getIndexFromId (FileInMemorySet me, const char32 *id) {
 	return index;
 }
 
+/*
+	The set is sorted by path (see s_compareHook), so we can do a binary search.
+*/
 integer FileInMemorySet_lookUp (FileInMemorySet me, const char32 *path) {
-	integer index = 0;
-	for (integer i = 1; i <= my size; i ++) {
-		FileInMemory fim = (FileInMemory) my at [i];
-		if (Melder_equ (path, fim -> d_path)) {
-			index = i;
-			break;
-		}
+	integer numberOfItems = my size;
+	if (numberOfItems == 0) return 0;
+
+	int atEnd = Melder_cmp (path, static_cast<FileInMemory> (my at [numberOfItems]) -> d_path);
+	if (atEnd > 0) return 0;
+	if (atEnd == 0) return numberOfItems;
+
+	int atStart = Melder_cmp (path, static_cast<FileInMemory> (my at [1]) -> d_path);
+	if (atStart < 0) return 0;
+	if (atStart == 0) return 1;
+
+	integer left = 1, right = numberOfItems;
+	while (left < right - 1) {
+		integer mid = (left + right) / 2;
+		int here = Melder_cmp (path, static_cast<FileInMemory> (my at [mid]) -> d_path);
+		if (here == 0) return mid;
+		if (here > 0) left = mid; else right = mid;
 	}
-	return index;
+	Melder_assert (right == left + 1);
+	return 0;
 }
 
 integer FileInMemorySet_findNumberOfMatches_path (FileInMemorySet me, kMelder_string which, const char32 *criterion) {
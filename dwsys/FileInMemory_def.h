@@ -39,6 +39,7 @@ oo_DEFINE_CLASS (FileInMemory, Daata)
 		oo_UBYTE (_dontOwnData)
 	#endif
 	#if oo_DECLARING
+		bool d_isOpen;   // set by FileInMemoryManager_fopen, cleared by FileInMemoryManager_fclose
 		void v_info () override; 
 	#endif
 	
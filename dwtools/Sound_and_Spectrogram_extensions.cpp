@@ -147,6 +147,7 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 
 		autoMelderProgress progess (U"BarkSpectrogram analysis");
 
+		autoSound_to_Spectrum_reuseFourierTable reuse;
 		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
 			double t = Sampled_indexToX (thee.get(), iframe);
 
@@ -226,6 +227,7 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 
 		autoMelderProgress progress (U"MelSpectrograms analysis");
 
+		autoSound_to_Spectrum_reuseFourierTable reuse;
 		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
 			double t = Sampled_indexToX (thee.get(), iframe);
 			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
@@ -335,6 +337,7 @@ autoSpectrogram Sound_Pitch_to_Spectrogram (Sound me, Pitch thee, double analysi
 		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoMelderProgress progress (U"Sound & Pitch: To FormantFilter");
+		autoSound_to_Spectrum_reuseFourierTable reuse;
 		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
 			double t = Sampled_indexToX (him.get(), iframe);
 			double b, f0 = Pitch_getValueAtTime (thee, t, kPitch_unit::HERTZ, 0);
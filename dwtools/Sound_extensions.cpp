@@ -1816,6 +1816,7 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 		thy z [channel] [3] = my z [channel] [ileft + 1];
 	}
 
+	autoFormulaProgram program = Formula_compileProgram (interpreter, thee.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 	integer istep = 1;
 	double xright = xleft + my dx, xmid; // !!
 	do {
@@ -1825,8 +1826,7 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 			thy z [channel] [2] = Vector_getValueAtX (me, xmid, channel, Vector_VALUE_INTERPOLATION_LINEAR);
 		}
 		Formula_Result result;
-		Formula_compile (interpreter, thee.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_run (ichannel, 2, & result);
+		FormulaProgram_run (program.get(), ichannel, 2, & result);
 		bool mid = (result. numericResult != 0.0);
 
 		thy dx *= 0.5;
@@ -1852,7 +1852,11 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double minimum, double maximum,
 	bool garnish, const char32 *method, integer numberOfBisections, const char32 *formula, Interpreter interpreter) {
 	
-	Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+	/*
+		The bisections compile the same formula for another Sound,
+		so our own compiled formula is kept as a separate program.
+	*/
+	autoFormulaProgram program = Formula_compileProgram (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 
 	integer ixmin, ixmax;
 	_Sound_getWindowExtrema (me, & tmin, & tmax, & minimum, & maximum, & ixmin, & ixmax);
@@ -1865,7 +1869,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 		Graphics_setWindow (g, tmin, tmax, minimum - (my ny - channel) * (maximum - minimum), maximum + (channel - 1) * (maximum - minimum));
 		if (str32str (method, U"bars") || str32str (method, U"Bars")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				FormulaProgram_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					double x = Sampled_indexToX (me, ix);
 					double y = my z [channel] [ix];
@@ -1886,7 +1890,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 			}
 		} else if (str32str (method, U"poles") || str32str (method, U"Poles")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				FormulaProgram_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					double x = Sampled_indexToX (me, ix);
 					double y = my z [channel] [ix];
@@ -1901,7 +1905,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 			}
 		} else if (str32str (method, U"speckles") || str32str (method, U"Speckles")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				FormulaProgram_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					double x = Sampled_indexToX (me, ix);
 					Graphics_speckle (g, x, my z [channel] [ix]);
@@ -1910,12 +1914,12 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 		} else {
 			// The default: draw as a curve.
 
-			Formula_run (channel, 1, & result);
+			FormulaProgram_run (program.get(), channel, 1, & result);
 			bool previous = (result. numericResult != 0.0); // numericResult == 0.0 means false!
 			integer istart = ixmin; // first sample of segment to be drawn
 			double xb, yb, xe, ye;
 			for (integer ix = ixmin + 1; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				FormulaProgram_run (program.get(), channel, ix, & result);
 				bool current = (result. numericResult != 0.0); // numericResult == 0.0 means false!
 				if (previous && not current) { 
 					/* 
@@ -1923,7 +1927,6 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 						1. Draw the curve between the sample numbers from istart to ix-1 (previous). 
 						2. Find the (x,y) in the interval between sample numbers ix-1 and ix (current) where the change from
 							T to F occurs and draw the line between the previous point and (x,y).
-						3. Compile the formula again because it has been changed during the interpolation
 					*/
 					xb = Matrix_columnToX (me, ix - 1);
 					yb = my z [channel] [ix - 1];
@@ -1933,19 +1936,16 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 					}
 					Sound_findIntermediatePoint_bs (me, channel, ix - 1, previous, current, formula, interpreter, numberOfBisections, & xe, & ye);
 					Graphics_line (g, xb, yb, xe, ye);
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				} else if (not previous && current ) {
 					/*
 						F to T change: we are entering a segment to be drawn.
-						1. Find the (x,y) where the F changes to T and then draw the line from that (x,y) to the current point.
-						2. Compile the formula again
+						Find the (x,y) where the F changes to T and then draw the line from that (x,y) to the current point.
 					*/
 					istart = ix;
 					Sound_findIntermediatePoint_bs (me, channel, ix - 1, previous, current, formula, interpreter, numberOfBisections, & xb, & yb);
 					xe = Sampled_indexToX (me, ix);
 					ye = my z [channel] [ix];
 					Graphics_line (g, xb, yb, xe, ye);
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				}
 				previous = current;
 			}
@@ -1971,7 +1971,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 void Sound_paintWhere (Sound me, Graphics g, Graphics_Colour colour, double tmin, double tmax, double minimum, double maximum, double level, bool garnish, integer numberOfBisections, const char32 *formula, Interpreter interpreter) {
 	try {
 		Formula_Result result;
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compileProgram (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);   // see Sound_drawWhere
 
 		integer ixmin, ixmax;
 		_Sound_getWindowExtrema (me, & tmin, & tmax, & minimum, & maximum, & ixmin, & ixmax);
@@ -1984,7 +1984,7 @@ void Sound_paintWhere (Sound me, Graphics g, Graphics_Colour colour, double tmin
 			double tmini = tmin, tmaxi = tmax, xe, ye;
 			integer ix = ixmin;
 			do {
-				Formula_run (channel, ix, & result);
+				FormulaProgram_run (program.get(), channel, ix, & result);
 				current = ( result. numericResult != 0.0 );
 				if (ix == ixmin) {
 					previous = current;
@@ -1997,7 +1997,6 @@ void Sound_paintWhere (Sound me, Graphics g, Graphics_Colour colour, double tmin
 						tmaxi = xe;
 						fill = true;
 					}
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				}
 				if (ix == ixmax && current) {
 					tmaxi = tmax;
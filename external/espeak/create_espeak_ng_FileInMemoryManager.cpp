@@ -20,8 +20,14 @@
 
 autoFileInMemoryManager create_espeak_ng_FileInMemoryManager () {
 	try{
-		autoFileInMemorySet espeak_ng = create_espeak_ng_FileInMemorySet ();
-		autoFileInMemoryManager me = FileInMemoryManager_create (espeak_ng.get());
+		/*
+			The set only links to the static espeak-ng data, so we take it over instead of
+			copying it with FileInMemoryManager_create (), which would duplicate all the data.
+		*/
+		autoFileInMemoryManager me = Thing_new (FileInMemoryManager);
+		my files = create_espeak_ng_FileInMemorySet ();
+		my openFiles = FileInMemorySet_create ();
+		my openFiles -> _initializeOwnership (false);
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"FileInMemoryManager for espeak-ng not created.");
@@ -189,6 +189,18 @@ int LoadDictionary(Translator *tr, const char *name, int no_error)
 	sprintf(fname, "%s%c%s_dict", path_home, PATHSEP, name);
 	size = GetFileLength(fname);
 
+#if DATA_FROM_SOURCECODE_FILES
+	// Praat: all translators share the read-only dictionary data of the file set (see DeleteTranslator)
+	(void) f;
+	tr->data_dictlist = NULL;
+	if (size > 0)
+		tr->data_dictlist = const_cast<char *> (espeak_io_getFileData(fname, &size));
+	if (tr->data_dictlist == NULL) {
+		if (no_error == 0)
+			fprintf(stderr, "Can't read dictionary file: '%s'\n", fname);
+		return 1;
+	}
+#else
 	if (tr->data_dictlist != NULL) {
 		free(tr->data_dictlist);
 		tr->data_dictlist = NULL;
@@ -209,6 +221,7 @@ int LoadDictionary(Translator *tr, const char *name, int no_error)
 	}
 	size = fread(tr->data_dictlist, 1, size, f);
 	fclose(f);
+#endif
 
 	int hash_number = get_int32_le (tr->data_dictlist);
 	length = get_int32_le (tr->data_dictlist + 4);
@@ -110,6 +110,24 @@ int espeak_io_GetFileLength (const char *filename) {
 	return -1;
 }
 
+/*
+	espeak_io_getFileData: returns a link to the bytes of a file in the file set, or nullptr if the file does not exist.
+	The file set is shared by all synthesizers and is never modified after initialization (espeakdata_praat_init),
+	so eSpeak can use the phoneme and dictionary data in place instead of reading a private copy at every initialization.
+*/
+const char *espeak_io_getFileData (const char *filename, int *numberOfBytes) {
+	FileInMemorySet me = ESPEAK_FILEINMEMORYMANAGER -> files.get();
+	integer index = FileInMemorySet_lookUp (me, Melder_peek8to32 (filename));
+	if (index == 0) {
+		return nullptr;
+	}
+	FileInMemory fim = static_cast<FileInMemory> (my at [index]);
+	if (numberOfBytes) {
+		*numberOfBytes = fim -> d_numberOfBytes;
+	}
+	return reinterpret_cast<const char *> (fim -> d_data);
+}
+
 /* 
 	espeak_io_GetVoices: mimics GetVoices of espeak-ng
 	If is_languange_file == 0 then /voices/ else /lang/ 
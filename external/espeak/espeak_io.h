@@ -60,6 +60,8 @@ int espeak_io_ungetc (int character, FILE * stream);
 
 int espeak_io_GetFileLength (const char *filename);
 
+const char *espeak_io_getFileData (const char *filename, int *numberOfBytes);
+
 void espeak_io_GetVoices (const char *path, int len_path_voices, int is_language_file);
 
 void espeak_ng_data_to_bigendian (void);
@@ -78,6 +78,16 @@ static espeak_ng_STATUS ReadPhFile(void **ptr, const char *fname, int *size, esp
 	if (length < 0) // length == -errno
 		return create_file_error_context(context, static_cast<espeak_ng_STATUS> (-length), buf);
 
+#if DATA_FROM_SOURCECODE_FILES
+	// Praat: the data are shared and read-only, link to them instead of copying (see FreePhData)
+	(void) f_in;
+	*ptr = const_cast<char *> (espeak_io_getFileData(buf, NULL));
+	if (*ptr == NULL)
+		return create_file_error_context(context, static_cast<espeak_ng_STATUS> (ENOENT), buf);
+	if (size != NULL)
+		*size = length;
+	return ENS_OK;
+#else
 	if ((f_in = fopen(buf, "rb")) == NULL)
 		return create_file_error_context(context, static_cast<espeak_ng_STATUS> (errno), buf);
 
@@ -99,6 +109,7 @@ static espeak_ng_STATUS ReadPhFile(void **ptr, const char *fname, int *size, esp
 	if (size != NULL)
 		*size = length;
 	return ENS_OK;
+#endif
 }
 
 espeak_ng_STATUS LoadPhData(int *srate, espeak_ng_ERROR_CONTEXT *context)
@@ -156,10 +167,12 @@ espeak_ng_STATUS LoadPhData(int *srate, espeak_ng_ERROR_CONTEXT *context)
 
 void FreePhData(void)
 {
+#if ! DATA_FROM_SOURCECODE_FILES
 	free(phoneme_tab_data);
 	free(phoneme_index);
 	free(phondata_ptr);
 	free(tunes);
+#endif
 	phoneme_tab_data = NULL;
 	phoneme_index = NULL;
 	phondata_ptr = NULL;
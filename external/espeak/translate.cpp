@@ -275,8 +275,10 @@ int isspace2(unsigned int c)
 
 void DeleteTranslator(Translator *tr)
 {
+#if ! DATA_FROM_SOURCECODE_FILES
 	if (tr->data_dictlist != NULL)
 		free(tr->data_dictlist);
+#endif
 	free(tr);
 }
 
@@ -155,28 +155,14 @@ autoManipulation Sound_PointProcess_to_Manipulation (Sound sound, PointProcess p
 void Manipulation_playPart (Manipulation me, double tmin, double tmax, int method) {
 	try {
 		if (method == Manipulation_OVERLAPADD) {
-			if (! my sound)
-				Melder_throw (U"Cannot synthesize overlap-add without a sound.");
-			autoSound part = Data_copy (my sound.get());
-			integer imin = Sampled_xToLowIndex (part.get(), tmin), imax = Sampled_xToHighIndex (part.get(), tmax);
-			double *amp = part -> z [1];
-			for (integer i = 1; i <= imin; i ++) amp [i] = 0.0;
-			for (integer i = imax; i <= part -> nx; i ++) amp [i] = 0.0;
-			autoSound saved = my sound.move();
-			my sound = part.move();
-			try {
-				autoSound played = Manipulation_to_Sound (me, Manipulation_OVERLAPADD);
-				my sound = saved.move();
-				amp = played -> z [1];
-				for (imin = 1; imin <= played -> nx; imin ++)
-					if (amp [imin] != 0.0) break;
-				for (imax = played -> nx; imax >= 1; imax --)
-					if (amp [imax] != 0.0) break;
-				Sound_playPart (played.get(), played -> x1 + (imin - 1.5) * played -> dx, played -> x1 + (imax - 0.5) * played -> dx, nullptr, nullptr);
-			} catch (MelderError) {
-				my sound = saved.move();
-				throw;
-			}
+			autoSound played = Manipulation_to_Sound_part_overlapAdd (me, tmin, tmax);
+			double *amp = played -> z [1];
+			integer imin, imax;
+			for (imin = 1; imin <= played -> nx; imin ++)
+				if (amp [imin] != 0.0) break;
+			for (imax = played -> nx; imax >= 1; imax --)
+				if (amp [imax] != 0.0) break;
+			Sound_playPart (played.get(), played -> x1 + (imin - 1.5) * played -> dx, played -> x1 + (imax - 0.5) * played -> dx, nullptr, nullptr);
 		} else {
 			autoSound sound = Manipulation_to_Sound (me, method);
 			Sound_playPart (sound.get(), tmin, tmax, nullptr, nullptr);
@@ -269,6 +255,91 @@ static void copyFlat (Sound me, double tmin, double tmax, Sound thee, double tmi
 	NUMvector_copyElements (my z [1] + imin, thy z [1] + iminTarget, 0, imax - imin);
 }
 
+/*
+	The geometry of target period `i`: the times it reads from `me` and the times it writes into the result.
+	Both spans are widened by two samples, to be on the safe side of the rounding of times to sample indices.
+*/
+static void Sound_Point_Point_getPeriodSpans (Sound me, PointProcess source, PointProcess target, double maxT, integer i,
+	double *readMin, double *readMax, double *writeMin, double *writeMax)
+{
+	double tmid = target -> t [i];
+	double tleft = i > 1 ? target -> t [i - 1] : my xmin;
+	double tright = i < target -> nt ? target -> t [i + 1] : my xmax;
+	double leftWidth = tmid - tleft, rightWidth = tright - tmid;
+	int leftVoiced = i > 1 && leftWidth <= maxT;
+	int rightVoiced = i < target -> nt && rightWidth <= maxT;
+	if (! leftVoiced) leftWidth = rightWidth;   // symmetric bell
+	if (! rightVoiced) rightWidth = leftWidth;   // symmetric bell
+	double tsource = source -> t [PointProcess_getNearestIndex (source, tmid)];
+	/*
+		The bell is written within `leftWidth` and `rightWidth` around `tmid`, the flat, rising and falling parts within [tleft, tright];
+		the flat, rising and falling parts read from the same times as they write to, the bell reads around the source pulse.
+	*/
+	double margin = 2.0 * my dx;
+	*writeMin = std::min (tleft, tmid - leftWidth) - margin;
+	*writeMax = std::max (tright, tmid + rightWidth) + margin;
+	*readMin = std::min (*writeMin, tsource - leftWidth - margin);
+	*readMax = std::max (*writeMax, tsource + rightWidth + margin);
+}
+
+static void Sound_Point_Point_addPeriod (Sound me, PointProcess source, PointProcess target, double maxT, Sound thee, integer i) {
+	double tmid = target -> t [i];
+	double tleft = i > 1 ? target -> t [i - 1] : my xmin;
+	double tright = i < target -> nt ? target -> t [i + 1] : my xmax;
+	double leftWidth = tmid - tleft, rightWidth = tright - tmid;
+	int leftVoiced = i > 1 && leftWidth <= maxT;
+	int rightVoiced = i < target -> nt && rightWidth <= maxT;
+	integer isource = PointProcess_getNearestIndex (source, tmid);
+	if (! leftVoiced) leftWidth = rightWidth;   // symmetric bell
+	if (! rightVoiced) rightWidth = leftWidth;   // symmetric bell
+	if (leftVoiced || rightVoiced) {
+		copyBell2 (me, source, isource, leftWidth, rightWidth, thee, tmid, maxT);
+		if (! leftVoiced) {
+			double startOfFlat = ( i == 1 ? tleft : (tleft + tmid) / 2.0 );
+			double endOfFlat = tmid - leftWidth;
+			copyFlat (me, startOfFlat, endOfFlat, thee, startOfFlat);
+			copyFall (me, endOfFlat, tmid, thee, endOfFlat);
+		} else if (! rightVoiced) {
+			double startOfFlat = tmid + rightWidth;
+			double endOfFlat = ( i == target -> nt ? tright : (tmid + tright) / 2.0 );
+			copyRise (me, tmid, startOfFlat, thee, startOfFlat);
+			copyFlat (me, startOfFlat, endOfFlat, thee, startOfFlat);
+		}
+	} else {
+		double startOfFlat = ( i == 1 ? tleft : (tleft + tmid) / 2.0 );
+		double endOfFlat = ( i == target -> nt ? tright : (tmid + tright) / 2.0 );
+		copyFlat (me, startOfFlat, endOfFlat, thee, startOfFlat);
+	}
+}
+
+/*
+	Overlap-add synthesis of a sound `me` that is silent outside [tmin, tmax].
+	Every period writes only to samples within its own span, but `copyFlat` overwrites instead of adds,
+	so a period that reads nothing but silence can still change the samples written by its neighbours.
+	Hence two passes. The first pass collects the span [writeFrom, writeTo] written by the periods that can read from [tmin, tmax];
+	outside this span, a synthesis of all periods would contain nothing but zeroes.
+	The second pass runs, in their original order, all the periods that write anywhere within that span,
+	so that the result is identical, sample by sample, to a synthesis of all the periods.
+*/
+static void Sound_Point_Point_into_Sound_part (Sound me, PointProcess source, PointProcess target, double maxT,
+	Sound thee, double tmin, double tmax)
+{
+	double writeFrom = INFINITY, writeTo = - INFINITY;
+	for (integer i = 1; i <= target -> nt; i ++) {
+		double readMin, readMax, writeMin, writeMax;
+		Sound_Point_Point_getPeriodSpans (me, source, target, maxT, i, & readMin, & readMax, & writeMin, & writeMax);
+		if (readMax < tmin || readMin > tmax) continue;
+		if (writeMin < writeFrom) writeFrom = writeMin;
+		if (writeMax > writeTo) writeTo = writeMax;
+	}
+	for (integer i = 1; i <= target -> nt; i ++) {
+		double readMin, readMax, writeMin, writeMax;
+		Sound_Point_Point_getPeriodSpans (me, source, target, maxT, i, & readMin, & readMax, & writeMin, & writeMax);
+		if (writeMax < writeFrom || writeMin > writeTo) continue;
+		Sound_Point_Point_addPeriod (me, source, target, maxT, thee, i);
+	}
+}
+
 autoSound Sound_Point_Point_to_Sound (Sound me, PointProcess source, PointProcess target, double maxT) {
 	try {
 		autoSound thee = Sound_create (1, my xmin, my xmax, my nx, my dx, my x1);
@@ -276,35 +347,8 @@ autoSound Sound_Point_Point_to_Sound (Sound me, PointProcess source, PointProces
 			NUMvector_copyElements (my z [1], thy z [1], 1, my nx);
 			return thee;
 		}
-		for (integer i = 1; i <= target -> nt; i ++) {
-			double tmid = target -> t [i];
-			double tleft = i > 1 ? target -> t [i - 1] : my xmin;
-			double tright = i < target -> nt ? target -> t [i + 1] : my xmax;
-			double leftWidth = tmid - tleft, rightWidth = tright - tmid;
-			int leftVoiced = i > 1 && leftWidth <= maxT;
-			int rightVoiced = i < target -> nt && rightWidth <= maxT;
-			integer isource = PointProcess_getNearestIndex (source, tmid);
-			if (! leftVoiced) leftWidth = rightWidth;   // symmetric bell
-			if (! rightVoiced) rightWidth = leftWidth;   // symmetric bell
-			if (leftVoiced || rightVoiced) {
-				copyBell2 (me, source, isource, leftWidth, rightWidth, thee.get(), tmid, maxT);
-				if (! leftVoiced) {
-					double startOfFlat = ( i == 1 ? tleft : (tleft + tmid) / 2.0 );
-					double endOfFlat = tmid - leftWidth;
-					copyFlat (me, startOfFlat, endOfFlat, thee.get(), startOfFlat);
-					copyFall (me, endOfFlat, tmid, thee.get(), endOfFlat);
-				} else if (! rightVoiced) {
-					double startOfFlat = tmid + rightWidth;
-					double endOfFlat = ( i == target -> nt ? tright : (tmid + tright) / 2.0 );
-					copyRise (me, tmid, startOfFlat, thee.get(), startOfFlat);
-					copyFlat (me, startOfFlat, endOfFlat, thee.get(), startOfFlat);
-				}
-			} else {
-				double startOfFlat = ( i == 1 ? tleft : (tleft + tmid) / 2.0 );
-				double endOfFlat = ( i == target -> nt ? tright : (tmid + tright) / 2.0 );
-				copyFlat (me, startOfFlat, endOfFlat, thee.get(), startOfFlat);
-			}
-		}
+		for (integer i = 1; i <= target -> nt; i ++)
+			Sound_Point_Point_addPeriod (me, source, target, maxT, thee.get(), i);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": not manipulated.");
@@ -473,6 +517,47 @@ static autoSound synthesize_overlapAdd_nodur (Manipulation me) {
 	}
 }
 
+static autoSound synthesize_overlapAdd_nodur_part (Manipulation me, Sound sound, double tmin, double tmax) {
+	try {
+		if (! my pulses) Melder_throw (U"Missing pulses analysis.");
+		if (! my pitch)  Melder_throw (U"Missing pitch manipulation.");
+		autoPointProcess targetPulses = PitchTier_Point_to_PointProcess (my pitch.get(), my pulses.get(), MAX_T);
+		if (my pulses -> nt < 2 || targetPulses -> nt < 2)
+			return Sound_Point_Point_to_Sound (sound, my pulses.get(), targetPulses.get(), MAX_T);
+		autoSound thee = Sound_create (1, sound -> xmin, sound -> xmax, sound -> nx, sound -> dx, sound -> x1);
+		Sound_Point_Point_into_Sound_part (sound, my pulses.get(), targetPulses.get(), MAX_T, thee.get(), tmin, tmax);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": overlap-add synthesis (without duration) not performed.");
+	}
+}
+
+autoSound Manipulation_to_Sound_part_overlapAdd (Manipulation me, double tmin, double tmax) {
+	try {
+		if (! my sound)
+			Melder_throw (U"Cannot synthesize overlap-add without a sound.");
+		autoSound part = Data_copy (my sound.get());
+		integer imin = Sampled_xToLowIndex (part.get(), tmin), imax = Sampled_xToHighIndex (part.get(), tmax);
+		double *amp = part -> z [1];
+		for (integer i = 1; i <= imin; i ++) amp [i] = 0.0;
+		for (integer i = imax; i <= part -> nx; i ++) amp [i] = 0.0;
+		if (! my duration || my duration -> points.size == 0)
+			return synthesize_overlapAdd_nodur_part (me, part.get(), tmin, tmax);
+		autoSound saved = my sound.move();
+		my sound = part.move();
+		try {
+			autoSound result = Manipulation_to_Sound (me, Manipulation_OVERLAPADD);
+			my sound = saved.move();
+			return result;
+		} catch (MelderError) {
+			my sound = saved.move();
+			throw;
+		}
+	} catch (MelderError) {
+		Melder_throw (me, U": part not synthesized.");
+	}
+}
+
 static autoSound synthesize_overlapAdd (Manipulation me) {
 	if (! my duration || my duration -> points.size == 0) return synthesize_overlapAdd_nodur (me);
 	try {
@@ -69,6 +69,12 @@ autoSound Sound_Point_Point_to_Sound (Sound me, PointProcess source, PointProces
 /*void Sound_Formant_Intensity_filter (Sound me, FormantTier formant, IntensityTier intensity);*/
 
 autoSound Manipulation_to_Sound (Manipulation me, int method);
+autoSound Manipulation_to_Sound_part_overlapAdd (Manipulation me, double tmin, double tmax);
+/*
+	The overlap-add resynthesis of the original sound, made silent outside [tmin, tmax];
+	this is what Manipulation_playPart plays. Without a duration manipulation,
+	only the periods that can influence the non-silent part are synthesized.
+*/
 void Manipulation_playPart (Manipulation me, double tmin, double tmax, int method);
 void Manipulation_play (Manipulation me, int method);
 void Manipulation_writeToTextFileWithoutSound (Manipulation me, MelderFile file);
@@ -629,6 +629,11 @@ void Matrix_formula (Matrix me, const char32 *expression, Interpreter interprete
 		Formula_Result result;
 		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		if (! target) target = me;
+		if (Formula_canRunBlocks ()) {   // every cell depends only on itself: run whole rows at a time
+			for (integer irow = 1; irow <= my ny; irow ++)
+				Formula_runBlock (irow, 1, my nx, target -> z [irow]);
+			return;
+		}
 		for (integer irow = 1; irow <= my ny; irow ++) {
 			for (integer icol = 1; icol <= my nx; icol ++) {
 				Formula_run (irow, icol, & result);
@@ -652,6 +657,11 @@ void Matrix_formula_part (Matrix me, double xmin, double xmax, double ymin, doub
 		Formula_Result result;
 		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		if (! target) target = me;
+		if (Formula_canRunBlocks ()) {
+			for (integer irow = iymin; irow <= iymax; irow ++)
+				Formula_runBlock (irow, ixmin, ixmax, target -> z [irow]);
+			return;
+		}
 		for (integer irow = iymin; irow <= iymax; irow ++) {
 			for (integer icol = ixmin; icol <= ixmax; icol ++) {
 				Formula_run (irow, icol, & result);
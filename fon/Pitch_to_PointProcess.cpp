@@ -35,6 +35,7 @@
 #include "Pitch_to_PointProcess.h"
 #include "PitchTier_to_PointProcess.h"
 #include "Pitch_to_PitchTier.h"
+#include "MelderThread.h"
 #include <ctype.h>
 
 autoPointProcess Pitch_to_PointProcess (Pitch pitch) {
@@ -135,15 +136,24 @@ static double Sound_findMaximumCorrelation (Sound me, double t1, double windowLe
 	Melder_assert (ileft2max >= ileft2min);   // if the loop is never executed, the result will be garbage
 	for (integer ileft2 = ileft2min; ileft2 <= ileft2max; ileft2 ++) {
 		double norm1 = 0.0, norm2 = 0.0, product = 0.0, localPeak = 0.0;
+		/*
+			Only the samples for which both i1 and i2 = i1 + lag lie inside the sound contribute;
+			clip the window once, so that the inner loop is a plain dot product without tests.
+		*/
+		integer lag = ileft2 - ileft1;
+		integer i1min = ileft1, i1max = iright1;
+		if (i1min < 1) i1min = 1;
+		if (i1min < 1 - lag) i1min = 1 - lag;
+		if (i1max > my nx) i1max = my nx;
+		if (i1max > my nx - lag) i1max = my nx - lag;
 		for (integer ichan = 1; ichan <= my ny; ichan ++) {
-			for (integer i1 = ileft1, i2 = ileft2; i1 <= iright1; i1 ++, i2 ++) {
-				if (i1 < 1 || i1 > my nx || i2 < 1 || i2 > my nx) continue;
-				double amp1 = my z [ichan] [i1], amp2 = my z [ichan] [i2];
-				norm1 += amp1 * amp1;
-				norm2 += amp2 * amp2;
-				product += amp1 * amp2;
-				if (fabs (amp2) > localPeak)
-					localPeak = fabs (amp2);
+			const double *amp1 = my z [ichan], *amp2 = my z [ichan] + lag;
+			for (integer i1 = i1min; i1 <= i1max; i1 ++) {
+				norm1 += amp1 [i1] * amp1 [i1];
+				norm2 += amp2 [i1] * amp2 [i1];
+				product += amp1 [i1] * amp2 [i1];
+				if (fabs (amp2 [i1]) > localPeak)
+					localPeak = fabs (amp2 [i1]);
 			}
 		}
 		r1 = r2;   // >= 0
@@ -174,147 +184,287 @@ static double Sound_findMaximumCorrelation (Sound me, double t1, double windowLe
 	return maximumCorrelation;
 }
 
-autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
+/*
+	The voiced intervals are searched for pulses independently of each other, in parallel.
+	The only thing that links a voiced interval to the previous one is `addedRight`,
+	the last pulse that was found to the right of an earlier middle pulse:
+	a pulse found to the left of the middle is accepted only if it lies far enough after `addedRight`.
+	So each thread records its candidate pulses in order, with that minimum distance,
+	and the candidates are accepted or rejected afterwards in a single sequential pass.
+*/
+
+struct PulseCandidate {
+	double time;
+	double minimumDistanceToAddedRight;   // 0.0 if the pulse is accepted unconditionally
+	bool isRight;   // found to the right of the middle pulse, i.e. becomes the new `addedRight`
+};
+
+Thing_define (Sound_Pitch_into_Pulses_Args, Thing) { public:
+	Sound sound;
+	Pitch pitch;
+	double *tleft, *tright;
+	integer firstInterval, lastInterval, numberOfIntervals;
+	bool useCorrelation;
+	int includeMaxima, includeMinima;
+	double globalPeak;
+	bool isMainThread;
+	volatile int *cancelled;
+	std::vector <PulseCandidate> candidates;   // reserved by the main thread; grows only if the estimate was too low
+	bool outOfMemory;   // set by the thread if `candidates` could not grow; reported by the main thread
+};
+
+Thing_implement (Sound_Pitch_into_Pulses_Args, Thing, 0);
+
+static autoSound_Pitch_into_Pulses_Args Sound_Pitch_into_Pulses_Args_create (Sound sound, Pitch pitch,
+	double *tleft, double *tright, integer firstInterval, integer lastInterval, integer numberOfIntervals,
+	bool useCorrelation, int includeMaxima, int includeMinima, double globalPeak,
+	bool isMainThread, volatile int *cancelled)
+{
+	autoSound_Pitch_into_Pulses_Args me = Thing_new (Sound_Pitch_into_Pulses_Args);
+	my sound = sound;
+	my pitch = pitch;
+	my tleft = tleft;
+	my tright = tright;
+	my firstInterval = firstInterval;
+	my lastInterval = lastInterval;
+	my numberOfIntervals = numberOfIntervals;
+	my useCorrelation = useCorrelation;
+	my includeMaxima = includeMaxima;
+	my includeMinima = includeMinima;
+	my globalPeak = globalPeak;
+	my isMainThread = isMainThread;
+	my cancelled = cancelled;
+	/*
+		Successive pulses are at least 0.8 periods apart, and the pitch hardly exceeds the ceiling,
+		so this will normally be enough room for all the pulses of our intervals.
+	*/
+	double numberOfPulses = 0.0;
+	for (integer iinterval = firstInterval; iinterval <= lastInterval; iinterval ++)
+		numberOfPulses += (tright [iinterval] - tleft [iinterval]) * pitch -> ceiling / 0.8 + 5.0;
+	if (numberOfPulses > 1e6) numberOfPulses = 1e6;   // it is only an estimate
 	try {
-		autoPointProcess point = PointProcess_create (sound -> xmin, sound -> xmax, 10);
-		double t = pitch -> xmin;
-		double addedRight = -1e308;
-		double globalPeak = Vector_getAbsoluteExtremum (sound, sound -> xmin, sound -> xmax, 0), peak;
-		
-		/*
-		 * Cycle over all voiced intervals.
-		 */
-		autoMelderProgress progress (U"Sound & Pitch: To PointProcess...");
-		for (;;) {
-			double tleft, tright;
-			if (! Pitch_getVoicedIntervalAfter (pitch, t, & tleft, & tright)) break;
-			Melder_assert (tright > t);
+		my candidates. reserve ((size_t) numberOfPulses);
+	} catch (std::bad_alloc&) {
+		Melder_throw (U"Out of memory: no room for ", Melder_bigInteger ((int64) numberOfPulses), U" pulse candidates.");
+	}
+	return me;
+}
 
-			/*
-			 * Go to the middle of the voice stretch.
-			 */
-			double tmiddle = (tleft + tright) / 2;
-			Melder_progress ((tmiddle - sound -> xmin) / (sound -> xmax - sound -> xmin), U"Sound & Pitch to PointProcess");
-			double f0middle = Pitch_getValueAtTime (pitch, tmiddle, kPitch_unit::HERTZ, Pitch_LINEAR);
+static bool Sound_Pitch_into_Pulses_Args_addCandidate (Sound_Pitch_into_Pulses_Args me, double time, double minimumDistanceToAddedRight, bool isRight) {
+	PulseCandidate candidate { time, minimumDistanceToAddedRight, isRight };
+	try {
+		my candidates. push_back (candidate);
+	} catch (std::bad_alloc&) {
+		my outOfMemory = true;   // not thrown here: we may be in a worker thread
+		return false;
+	}
+	return true;
+}
 
-			/*
-			 * Our first point is near this middle.
-			 */
-			if (isundef (f0middle)) {
-				Melder_fatal (U"Sound_Pitch_to_PointProcess_cc:"
-					U" tleft ", tleft,
-					U", tright ", tright,
-					U", f0middle ", f0middle
-				);
-			}
-			double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, true, true);
-			Melder_assert (isdefined (tmax));
-			PointProcess_addPoint (point.get(), tmax);
+static void Sound_Pitch_into_Pulses_cc (Sound_Pitch_into_Pulses_Args me, double tleft, double tright) {
+	Sound sound = my sound;
+	Pitch pitch = my pitch;
+	double peak;
+	/*
+	 * Go to the middle of the voice stretch.
+	 */
+	double tmiddle = (tleft + tright) / 2;
+	double f0middle = Pitch_getValueAtTime (pitch, tmiddle, kPitch_unit::HERTZ, Pitch_LINEAR);
+
+	/*
+	 * Our first point is near this middle.
+	 */
+	if (isundef (f0middle)) {
+		Melder_fatal (U"Sound_Pitch_to_PointProcess_cc:"
+			U" tleft ", tleft,
+			U", tright ", tright,
+			U", f0middle ", f0middle
+		);
+	}
+	double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, true, true);
+	Melder_assert (isdefined (tmax));
+	if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.0, false)) return;
 
-			double tsave = tmax;
-			for (;;) {
-				double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR), correlation;
-				if (isundef (f0)) break;
-				correlation = Sound_findMaximumCorrelation (sound, tmax, 1.0 / f0, tmax - 1.25 / f0, tmax - 0.8 / f0, & tmax, & peak);
-				if (correlation == -1) /*break*/ tmax -= 1.0 / f0;   // this one period will drop out
-				if (tmax < tleft) {
-					if (correlation > 0.7 && peak > 0.023333 * globalPeak && tmax - addedRight > 0.8 / f0) {
-						PointProcess_addPoint (point.get(), tmax);
-					}
-					break;
-				}
-				if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * globalPeak)) {
-					if (tmax - addedRight > 0.8 / f0) {   // do not fill in a short originally unvoiced interval twice
-						PointProcess_addPoint (point.get(), tmax);
-					}
-				}
+	double tsave = tmax;
+	for (;;) {
+		double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR), correlation;
+		if (isundef (f0)) break;
+		correlation = Sound_findMaximumCorrelation (sound, tmax, 1.0 / f0, tmax - 1.25 / f0, tmax - 0.8 / f0, & tmax, & peak);
+		if (correlation == -1) /*break*/ tmax -= 1.0 / f0;   // this one period will drop out
+		if (tmax < tleft) {
+			if (correlation > 0.7 && peak > 0.023333 * my globalPeak) {
+				if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.8 / f0, false)) return;
 			}
-			tmax = tsave;
-			for (;;) {
-				double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR), correlation;
-				if (isundef (f0)) break;
-				correlation = Sound_findMaximumCorrelation (sound, tmax, 1.0 / f0, tmax + 0.8 / f0, tmax + 1.25 / f0, & tmax, & peak);
-				if (correlation == -1) /*break*/ tmax += 1.0 / f0;
-				if (tmax > tright) {
-					if (correlation > 0.7 && peak > 0.023333 * globalPeak) {
-						PointProcess_addPoint (point.get(), tmax);
-						addedRight = tmax;
-					}
-					break;
-				}
-				if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * globalPeak)) {
-					PointProcess_addPoint (point.get(), tmax);
-					addedRight = tmax;
-				}
+			break;
+		}
+		if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * my globalPeak)) {
+			// do not fill in a short originally unvoiced interval twice
+			if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.8 / f0, false)) return;
+		}
+	}
+	tmax = tsave;
+	for (;;) {
+		double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR), correlation;
+		if (isundef (f0)) break;
+		correlation = Sound_findMaximumCorrelation (sound, tmax, 1.0 / f0, tmax + 0.8 / f0, tmax + 1.25 / f0, & tmax, & peak);
+		if (correlation == -1) /*break*/ tmax += 1.0 / f0;
+		if (tmax > tright) {
+			if (correlation > 0.7 && peak > 0.023333 * my globalPeak) {
+				if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.0, true)) return;
 			}
-			t = tright;
+			break;
+		}
+		if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * my globalPeak)) {
+			if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.0, true)) return;
 		}
-		return point;
-	} catch (MelderError) {
-		Melder_throw (sound, U" & ", pitch, U": not converted to PointProcess (cc).");
 	}
 }
-	
 
-autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, int includeMaxima, int includeMinima) {
-	try {
-		autoPointProcess point = PointProcess_create (sound -> xmin, sound -> xmax, 10);
-		double t = pitch -> xmin;
-		double addedRight = -1e308;
-		/*
-		 * Cycle over all voiced intervals.
-		 */
+static void Sound_Pitch_into_Pulses_peaks (Sound_Pitch_into_Pulses_Args me, double tleft, double tright) {
+	Sound sound = my sound;
+	Pitch pitch = my pitch;
+	/*
+	 * Go to the middle of the voiced interval.
+	 */
+	double tmiddle = (tleft + tright) / 2;
+	double f0middle = Pitch_getValueAtTime (pitch, tmiddle, kPitch_unit::HERTZ, Pitch_LINEAR);
 
-		autoMelderProgress progress (U"Sound & Pitch: To PointProcess");
-		for (;;) {
-			double tleft, tright;
-			if (! Pitch_getVoicedIntervalAfter (pitch, t, & tleft, & tright)) break;
-			/*
-			 * Go to the middle of the voiced interval.
-			 */
-			double tmiddle = (tleft + tright) / 2;
-			Melder_progress ((tmiddle - sound -> xmin) / (sound -> xmax - sound -> xmin), U"Sound & Pitch: To PointProcess");
-			double f0middle = Pitch_getValueAtTime (pitch, tmiddle, kPitch_unit::HERTZ, Pitch_LINEAR);
+	/*
+	 * Our first point is near this middle.
+	 */
+	Melder_assert (isdefined (f0middle));
+	double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, my includeMaxima, my includeMinima);
+	Melder_assert (isdefined (tmax));
+	if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.0, false)) return;
 
-			/*
-			 * Our first point is near this middle.
-			 */
-			Melder_assert (isdefined (f0middle));
-			double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, includeMaxima, includeMinima);
-			Melder_assert (isdefined (tmax));
-			PointProcess_addPoint (point.get(), tmax);
+	double tsave = tmax;
+	for (;;) {
+		double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR);
+		if (isundef (f0)) break;
+		tmax = Sound_findExtremum (sound, tmax - 1.25 / f0, tmax - 0.8 / f0, my includeMaxima, my includeMinima);
+		// do not fill in a short originally unvoiced interval twice
+		if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.8 / f0, false)) return;
+		if (tmax < tleft)
+			break;
+	}
+	tmax = tsave;
+	for (;;) {
+		double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR);
+		if (isundef (f0)) break;
+		tmax = Sound_findExtremum (sound, tmax + 0.8 / f0, tmax + 1.25 / f0, my includeMaxima, my includeMinima);
+		if (! Sound_Pitch_into_Pulses_Args_addCandidate (me, tmax, 0.0, true)) return;
+		if (tmax > tright)
+			break;
+	}
+}
 
-			double tsave = tmax;
-			for (;;) {
-				double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR);
-				if (isundef (f0)) break;
-				tmax = Sound_findExtremum (sound, tmax - 1.25 / f0, tmax - 0.8 / f0, includeMaxima, includeMinima);
-				if (tmax < tleft) {
-					if (tmax - addedRight > 0.8 / f0) {
-						PointProcess_addPoint (point.get(), tmax);
-					}
-					break;
-				}
-				if (tmax - addedRight > 0.8 / f0) {   // do not fill in a short originally unvoiced interval twice
-					PointProcess_addPoint (point.get(), tmax);
-				}
+static MelderThread_RETURN_TYPE Sound_Pitch_into_Pulses (Sound_Pitch_into_Pulses_Args me) {
+	for (integer iinterval = my firstInterval; iinterval <= my lastInterval; iinterval ++) {
+		if (my isMainThread) {
+			try {
+				Melder_progress ((double) iinterval / my numberOfIntervals, U"Sound & Pitch: To PointProcess");
+			} catch (MelderError) {
+				*my cancelled = 1;
+				throw;
 			}
-			tmax = tsave;
-			for (;;) {
-				double f0 = Pitch_getValueAtTime (pitch, tmax, kPitch_unit::HERTZ, Pitch_LINEAR);
-				if (isundef (f0)) break;
-				tmax = Sound_findExtremum (sound, tmax + 0.8 / f0, tmax + 1.25 / f0, includeMaxima, includeMinima);
-				if (tmax > tright) {
-					PointProcess_addPoint (point.get(), tmax);
-					addedRight = tmax;
-					break;
-				}
-				PointProcess_addPoint (point.get(), tmax);
-				addedRight = tmax;
-			}
-			t = tright;
+		} else if (*my cancelled) {
+			MelderThread_RETURN;
 		}
+		if (my useCorrelation)
+			Sound_Pitch_into_Pulses_cc (me, my tleft [iinterval], my tright [iinterval]);
+		else
+			Sound_Pitch_into_Pulses_peaks (me, my tleft [iinterval], my tright [iinterval]);
+		if (my outOfMemory)
+			MelderThread_RETURN;
+	}
+	MelderThread_RETURN;
+}
+
+static autoPointProcess Sound_Pitch_to_PointProcess_any (Sound sound, Pitch pitch, bool useCorrelation, int includeMaxima, int includeMinima) {
+	autoPointProcess point = PointProcess_create (sound -> xmin, sound -> xmax, 10);
+	double globalPeak = ( useCorrelation ? Vector_getAbsoluteExtremum (sound, sound -> xmin, sound -> xmax, 0) : 0.0 );
+
+	/*
+	 * Collect all voiced intervals.
+	 */
+	integer numberOfIntervals = 0;
+	for (double t = pitch -> xmin;;) {
+		double tleft, tright;
+		if (! Pitch_getVoicedIntervalAfter (pitch, t, & tleft, & tright)) break;
+		Melder_assert (tright > t);
+		numberOfIntervals ++;
+		t = tright;
+	}
+	if (numberOfIntervals == 0)
 		return point;
+	autoNUMvector <double> tleft (1, numberOfIntervals), tright (1, numberOfIntervals);
+	integer iinterval = 0;
+	for (double t = pitch -> xmin;;) {
+		double tleft_, tright_;
+		if (! Pitch_getVoicedIntervalAfter (pitch, t, & tleft_, & tright_)) break;
+		tleft [++ iinterval] = tleft_;
+		tright [iinterval] = tright_;
+		t = tright_;
+	}
+
+	/*
+	 * Search the voiced intervals for pulses.
+	 */
+	autoMelderProgress progress (U"Sound & Pitch: To PointProcess...");
+	integer numberOfIntervalsPerThread = 5;
+	int numberOfThreads = (numberOfIntervals - 1) / numberOfIntervalsPerThread + 1;
+	const int numberOfProcessors = MelderThread_getNumberOfProcessors ();
+	if (numberOfThreads > numberOfProcessors) numberOfThreads = numberOfProcessors;
+	if (numberOfThreads > 16) numberOfThreads = 16;
+	if (numberOfThreads < 1) numberOfThreads = 1;
+	numberOfIntervalsPerThread = (numberOfIntervals - 1) / numberOfThreads + 1;
+
+	autoSound_Pitch_into_Pulses_Args args [16];
+	integer firstInterval = 1, lastInterval = numberOfIntervalsPerThread;
+	volatile int cancelled = 0;
+	for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		if (ithread == numberOfThreads || lastInterval > numberOfIntervals) lastInterval = numberOfIntervals;
+		args [ithread - 1] = Sound_Pitch_into_Pulses_Args_create (sound, pitch, tleft.peek(), tright.peek(),
+			firstInterval, lastInterval, numberOfIntervals, useCorrelation, includeMaxima, includeMinima, globalPeak,
+			ithread == numberOfThreads, & cancelled);
+		firstInterval = lastInterval + 1;
+		lastInterval += numberOfIntervalsPerThread;
+	}
+	MelderThread_run (Sound_Pitch_into_Pulses, args, numberOfThreads);
+
+	/*
+	 * Accept the candidates in the order in which a serial search would have found them.
+	 */
+	for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		if (args [ithread - 1] -> outOfMemory)
+			Melder_throw (U"Out of memory while collecting pulse candidates.");
+	}
+	double addedRight = -1e308;
+	for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		Sound_Pitch_into_Pulses_Args thread = args [ithread - 1].get();
+		for (size_t icand = 0; icand < thread -> candidates.size(); icand ++) {
+			PulseCandidate *candidate = & thread -> candidates [icand];
+			if (candidate -> minimumDistanceToAddedRight > 0.0 && candidate -> time - addedRight <= candidate -> minimumDistanceToAddedRight)
+				continue;
+			PointProcess_addPoint (point.get(), candidate -> time);
+			if (candidate -> isRight)
+				addedRight = candidate -> time;
+		}
+	}
+	return point;
+}
+
+autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
+	try {
+		return Sound_Pitch_to_PointProcess_any (sound, pitch, true, true, true);
+	} catch (MelderError) {
+		Melder_throw (sound, U" & ", pitch, U": not converted to PointProcess (cc).");
+	}
+}
+
+autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, int includeMaxima, int includeMinima) {
+	try {
+		return Sound_Pitch_to_PointProcess_any (sound, pitch, false, includeMaxima, includeMinima);
 	} catch (MelderError) {
 		Melder_throw (sound, U" & ", pitch, U": not converted to PointProcess (peaks).");
 	}
@@ -34,6 +34,30 @@
 #include "Sound_and_Spectrum.h"
 #include "NUM2.h"
 
+static thread_local int theFourierTableReuseDepth = 0;
+static thread_local structNUMfft_Table theReusedFourierTable { };
+
+autoSound_to_Spectrum_reuseFourierTable :: autoSound_to_Spectrum_reuseFourierTable () {
+	theFourierTableReuseDepth += 1;
+}
+
+autoSound_to_Spectrum_reuseFourierTable :: ~autoSound_to_Spectrum_reuseFourierTable () {
+	if (-- theFourierTableReuseDepth == 0) {
+		NUMvector_free (theReusedFourierTable. trigcache, 0);
+		NUMvector_free (theReusedFourierTable. splitcache, 0);
+		theReusedFourierTable = structNUMfft_Table { };
+	}
+}
+
+static NUMfft_Table getReusedFourierTable (integer numberOfSamples) {
+	if (theReusedFourierTable. n != numberOfSamples) {
+		autoNUMfft_Table newTable;
+		NUMfft_Table_init (& newTable, numberOfSamples);
+		std::swap (theReusedFourierTable, static_cast <structNUMfft_Table&> (newTable));   // the old table is freed by newTable's destructor
+	}
+	return & theReusedFourierTable;
+}
+
 autoSpectrum Sound_to_Spectrum (Sound me, int fast) {
 	try {
 		integer numberOfSamples = my nx;
@@ -67,9 +91,15 @@ autoSpectrum Sound_to_Spectrum (Sound me, int fast) {
 			}
 		}
 
-		autoNUMfft_Table fourierTable;
-		NUMfft_Table_init (& fourierTable, numberOfSamples);
-		NUMfft_forward (& fourierTable, data.peek());
+		autoNUMfft_Table ownFourierTable;
+		NUMfft_Table fourierTable;
+		if (theFourierTableReuseDepth > 0) {
+			fourierTable = getReusedFourierTable (numberOfSamples);
+		} else {
+			NUMfft_Table_init (& ownFourierTable, numberOfSamples);
+			fourierTable = & ownFourierTable;
+		}
+		NUMfft_forward (fourierTable, data.peek());
 
 		autoSpectrum thee = Spectrum_create (0.5 / my dx, numberOfFrequencies);
 		thy dx = 1.0 / (my dx * numberOfSamples);   // override
@@ -23,6 +23,25 @@ Thing_declare (Interpreter);
 autoSpectrum Sound_to_Spectrum_at (Sound me, double tim, double windowDuration, int windowType);
 
 autoSpectrum Sound_to_Spectrum (Sound me, int fast);
+
+/*
+	Frame-by-frame analyses call Sound_to_Spectrum once per frame, always with the same number of samples.
+	While an autoSound_to_Spectrum_reuseFourierTable object lives, Sound_to_Spectrum (in the same thread)
+	computes its Fourier table only once and reuses it in every later call;
+	the table is freed when the outermost such object goes out of scope.
+	Usage:
+		autoSound_to_Spectrum_reuseFourierTable reuse;
+		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
+			autoSpectrum spectrum = Sound_to_Spectrum (frame.get(), true);
+			...
+		}
+*/
+struct autoSound_to_Spectrum_reuseFourierTable {
+	autoSound_to_Spectrum_reuseFourierTable ();
+	~autoSound_to_Spectrum_reuseFourierTable ();
+	autoSound_to_Spectrum_reuseFourierTable (const autoSound_to_Spectrum_reuseFourierTable&) = delete;
+	autoSound_to_Spectrum_reuseFourierTable& operator= (const autoSound_to_Spectrum_reuseFourierTable&) = delete;
+};
 autoSound Spectrum_to_Sound (Spectrum me);
 
 autoSpectrum Spectrum_lpcSmoothing (Spectrum me, int numberOfPeaks, double preemphasisFrequency);
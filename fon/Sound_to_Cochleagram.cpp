@@ -46,6 +46,7 @@ autoCochleagram Sound_to_Cochleagram (Sound me, double dt, double df, double dt_
 		double t1 = my x1 + 0.5 * (duration - my dx - (nFrames - 1) * dt);   // centre of first frame
 		autoCochleagram thee = Cochleagram_create (my xmin, my xmax, nFrames, dt, t1, df, nf);
 		autoSound window = Sound_createSimple (1, nsamp_window * my dx, 1.0 / my dx);
+		autoSound_to_Spectrum_reuseFourierTable reuse;
 		for (integer iframe = 1; iframe <= nFrames; iframe ++) {
 			double t = Sampled_indexToX (thee.get(), iframe);
 			integer leftSample = Sampled_xToLowIndex (me, t);
@@ -1311,6 +1311,16 @@ DIRECT (NEW_Manipulation_getResynthesis_overlapAdd) {
 	CONVERT_EACH_END (my name)
 }
 
+FORM (NEW_Manipulation_getResynthesisOfPart_overlapAdd, U"Manipulation: Get resynthesis of part (overlap-add)", nullptr) {
+	REAL (fromTime, U"left Time range (s)", U"0.0")
+	REAL (toTime, U"right Time range (s)", U"0.1")
+	OK
+DO
+	CONVERT_EACH (Manipulation)
+		autoSound result = Manipulation_to_Sound_part_overlapAdd (me, fromTime, toTime);
+	CONVERT_EACH_END (my name, U"_part")
+}
+
 DIRECT (HELP_Manipulation_help) {
 	HELP (U"Manipulation")
 }
@@ -2743,6 +2753,37 @@ DIRECT (NEW_Strings_to_Distributions) {
 	CONVERT_EACH_END (my name)
 }
 
+struct Strings_readFromFiles_Closure {
+	Strings fileNames;
+	const char32 *folder;
+};
+
+static const char32 * Strings_readFromFiles_getPath (void *void_closure, integer ifile) {
+	Strings_readFromFiles_Closure *closure = static_cast <Strings_readFromFiles_Closure *> (void_closure);
+	const char32 *fileName = closure -> fileNames -> strings [ifile];
+	return closure -> folder [0] == U'\0' ? fileName : Melder_cat (closure -> folder, U"/", fileName);
+}
+
+static void Strings_readFromFiles_readFile (void *void_closure, integer ifile) {
+	structMelderFile file { };
+	Melder_relativePathToFile (Strings_readFromFiles_getPath (void_closure, ifile), & file);
+	autoDaata object = Data_readFromFile (& file);
+	if (! object) return;
+	praat_newWithFile (object.move(), & file, MelderFile_name (& file));
+}
+
+FORM (NEWMANY_Strings_readFromFiles, U"Strings: Read from files", nullptr) {
+	TEXTFIELD (folder, U"Folder (empty if the strings are whole paths):", U"")
+	OK
+DO
+	LOOP {
+		iam (Strings);
+		Strings_readFromFiles_Closure closure { me, folder };
+		Melder_readFilesWithPrefetching (my numberOfStrings, Strings_readFromFiles_getPath, Strings_readFromFiles_readFile, & closure);
+	}
+	END
+}
+
 DIRECT (NEW_Strings_to_WordList) {
 	CONVERT_EACH (Strings)
 		autoWordList result = Strings_to_WordList (me);
@@ -3135,6 +3176,7 @@ praat_addAction1 (classFormant, 0, U"Hack", nullptr, 0, nullptr);
 	praat_addAction1 (classManipulation, 0, U"Get resynthesis (overlap-add)", nullptr, 0, NEW_Manipulation_getResynthesis_overlapAdd);
 	praat_addAction1 (classManipulation, 0,   U"Get resynthesis (PSOLA)", U"*Get resynthesis (overlap-add)", praat_DEPRECATED_2007, NEW_Manipulation_getResynthesis_overlapAdd);
 	praat_addAction1 (classManipulation, 0, U"Get resynthesis (LPC)", nullptr, 0, NEW_Manipulation_getResynthesis_lpc);
+	praat_addAction1 (classManipulation, 0, U"Get resynthesis of part (overlap-add)...", nullptr, praat_HIDDEN, NEW_Manipulation_getResynthesisOfPart_overlapAdd);
 	praat_addAction1 (classManipulation, 0, U"Extract original sound", nullptr, 0, NEW_Manipulation_extractOriginalSound);
 	praat_addAction1 (classManipulation, 0, U"Extract pulses", nullptr, 0, NEW_Manipulation_extractPulses);
 	praat_addAction1 (classManipulation, 0, U"Extract pitch tier", nullptr, 0, NEW_Manipulation_extractPitchTier);
@@ -3328,6 +3370,7 @@ praat_addAction1 (classPolygon, 0, U"Hack -", nullptr, 0, nullptr);
 		praat_addAction1 (classStrings, 0, U"Nativize", U"*Convert to Unicode", praat_DEPTH_1 | praat_DEPRECATED_2016, MODIFY_Strings_nativize);
 	praat_addAction1 (classStrings, 0, U"Convert -", nullptr, 0, nullptr);
 		praat_addAction1 (classStrings, 0, U"Replace all...", nullptr, 1, NEW_Strings_replaceAll);
+	praat_addAction1 (classStrings, 1, U"Read from files...", nullptr, 0, NEWMANY_Strings_readFromFiles);
 	praat_addAction1 (classStrings, 0, U"Analyze", nullptr, 0, nullptr);
 		praat_addAction1 (classStrings, 0, U"To Distributions", nullptr, 0, NEW_Strings_to_Distributions);
 	praat_addAction1 (classStrings, 0, U"Synthesize", nullptr, 0, nullptr);
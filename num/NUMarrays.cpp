@@ -126,6 +126,30 @@ void NUMvector_insert_generic (integer elementSize, byte **v, integer lo, intege
 
 /*** Generic memory functions for matrices. ***/
 
+/*
+	The cells of a matrix form a single block, row after row, without gaps,
+	so that the stride from one row to the next is exactly the number of columns.
+	The first cell is aligned to a cache line (64 bytes), which helps vectorized loops and BLAS routines;
+	the pointer that was actually allocated is kept just before the first cell, for NUMmatrix_free_.
+*/
+#define NUMmatrix_CELL_ALIGNMENT  64
+
+static byte * NUMmatrix_allocateCells (int64 numberOfBytes, bool initializeToZero) {
+	const int64 numberOfBytesToAllocate = numberOfBytes + NUMmatrix_CELL_ALIGNMENT + (int64) sizeof (byte *);
+	byte * const room = initializeToZero ?
+		reinterpret_cast <byte *> (_Melder_calloc (numberOfBytesToAllocate, 1)) :
+		reinterpret_cast <byte *> (_Melder_malloc (numberOfBytesToAllocate));
+	const uintptr_t firstPossibleCell = reinterpret_cast <uintptr_t> (room) + sizeof (byte *);
+	byte * const cells = reinterpret_cast <byte *> ((firstPossibleCell + (NUMmatrix_CELL_ALIGNMENT - 1)) & ~ (uintptr_t) (NUMmatrix_CELL_ALIGNMENT - 1));
+	reinterpret_cast <byte **> (cells) [-1] = room;
+	return cells;
+}
+
+static void NUMmatrix_freeCells (byte *cells) noexcept {
+	byte *room = reinterpret_cast <byte **> (cells) [-1];
+	Melder_free (room);
+}
+
 void * NUMmatrix (integer elementSize, integer row1, integer row2, integer col1, integer col2, bool initializeToZero) {
 	try {
 		const int64 numberOfRows = row2 - row1 + 1;
@@ -142,9 +166,7 @@ void * NUMmatrix (integer elementSize, integer row1, integer row2, integer col1,
 			(void) Melder_realloc_f (roomForRows, 1);   // make "sure" that the second try will succeed (if this is an in-place realloc)
 		}
 		try {
-			byte * const roomForCells = initializeToZero ?
-				reinterpret_cast <byte *> (_Melder_calloc (numberOfCells, elementSize)) :
-				reinterpret_cast <byte *> (_Melder_malloc (numberOfCells * elementSize));
+			byte * const roomForCells = NUMmatrix_allocateCells (numberOfCells * elementSize, initializeToZero);
 			byte *p_cell = roomForCells - col1 * elementSize;
 			const int64 rowSize = numberOfColumns * elementSize;
 			for (integer irow = row1; irow <= row2; irow ++) {
@@ -229,7 +251,7 @@ byte *** NUMtensor3_generic (integer elementSize, integer pla1, integer pla2, in
 void NUMmatrix_free_ (integer elementSize, byte **m, integer row1, integer col1) noexcept {
 	if (! m) return;
 	byte *cells = & m [row1] [col1 * elementSize];
-	Melder_free (cells);
+	NUMmatrix_freeCells (cells);
 	byte **rowPointers = & m [row1];
 	Melder_free (rowPointers);
 	theTotalNumberOfArrays -= 1;
@@ -276,17 +298,57 @@ bool NUMmatrix_equal (integer elementSize, void *m1, void *m2, integer row1, int
 
 /*** Typed I/O routines for vectors and matrices. ***/
 
+/*
+	Binary reading and writing of n consecutive elements. Most storage types go element by element;
+	the floating-point types, which make up the bulk of most binary files, go block by block.
+*/
+#define ELEMENTWISE(type,storage)  \
+	static void NUMbinget_##storage (type *x, integer n, FILE *f) { \
+		for (integer i = 0; i < n; i ++) \
+			x [i] = binget##storage (f); \
+	} \
+	static void NUMbinput_##storage (const type *x, integer n, FILE *f) { \
+		for (integer i = 0; i < n; i ++) \
+			binput##storage (x [i], f); \
+	}
+
+ELEMENTWISE (signed char, i8)
+ELEMENTWISE (int, i16)
+ELEMENTWISE (long, i32)
+ELEMENTWISE (integer, integer32BE)
+ELEMENTWISE (unsigned char, u8)
+ELEMENTWISE (unsigned int, u16)
+ELEMENTWISE (unsigned long, u32)
+ELEMENTWISE (dcomplex, c64)
+ELEMENTWISE (dcomplex, c128)
+#undef ELEMENTWISE
+
+static void NUMbinget_r32 (double *x, integer n, FILE *f) {
+	bingetr32array (x, n, f);
+}
+static void NUMbinput_r32 (const double *x, integer n, FILE *f) {
+	for (integer i = 0; i < n; i ++)
+		binputr32 (x [i], f);   // element by element, because binputr32 rounds in its own way on non-IEEE-MSB machines
+}
+static void NUMbinget_r64 (double *x, integer n, FILE *f) {
+	bingetr64array (x, n, f);
+}
+static void NUMbinput_r64 (const double *x, integer n, FILE *f) {
+	binputr64array (x, n, f);
+}
+
 #define FUNCTION(type,storage)  \
 	void NUMvector_writeText_##storage (const type *v, integer lo, integer hi, MelderFile file, const char32 *name) { \
 		texputintro (file, name, U" []: ", hi >= lo ? nullptr : U"(empty)", 0,0,0); \
+		const bool verbose = file -> verbose;   /* the element labels are needed only in long text files */ \
 		for (integer i = lo; i <= hi; i ++) \
-			texput##storage (file, v [i], name, U" [", Melder_integer (i), U"]", 0,0); \
+			texput##storage (file, v [i], name, U" [", verbose ? Melder_integer (i) : nullptr, U"]", 0,0); \
 		texexdent (file); \
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void NUMvector_writeBinary_##storage (const type *v, integer lo, integer hi, FILE *f) { \
-		for (integer i = lo; i <= hi; i ++) \
-			binput##storage (v [i], f); \
+		if (hi >= lo) \
+			NUMbinput_##storage (& v [lo], hi - lo + 1, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	type * NUMvector_readText_##storage (integer lo, integer hi, MelderReadText text, const char *name) { \
@@ -309,10 +371,9 @@ bool NUMmatrix_equal (integer elementSize, void *m1, void *m2, integer row1, int
 	type * NUMvector_readBinary_##storage (integer lo, integer hi, FILE *f) { \
 		type *result = nullptr; \
 		try { \
-			result = NUMvector <type> (lo, hi); \
-			for (integer i = lo; i <= hi; i ++) { \
-				result [i] = binget##storage (f); \
-			} \
+			result = NUMvector <type> (lo, hi, false); \
+			if (hi >= lo) \
+				NUMbinget_##storage (& result [lo], hi - lo + 1, f); \
 			return result; \
 		} catch (MelderError) { \
 			NUMvector_free (result, lo); \
@@ -321,11 +382,12 @@ bool NUMmatrix_equal (integer elementSize, void *m1, void *m2, integer row1, int
 	} \
 	void NUMmatrix_writeText_##storage (type **m, integer row1, integer row2, integer col1, integer col2, MelderFile file, const char32 *name) { \
 		texputintro (file, name, U" [] []: ", row2 >= row1 ? nullptr : U"(empty)", 0,0,0); \
+		const bool verbose = file -> verbose;   /* the element labels are needed only in long text files */ \
 		if (row2 >= row1) { \
 			for (integer irow = row1; irow <= row2; irow ++) { \
 				texputintro (file, name, U" [", Melder_integer (irow), U"]:", 0,0); \
 				for (integer icol = col1; icol <= col2; icol ++) { \
-					texput##storage (file, m [irow] [icol], name, U" [", Melder_integer (irow), U"] [", Melder_integer (icol), U"]"); \
+					texput##storage (file, m [irow] [icol], name, U" [", verbose ? Melder_integer (irow) : nullptr, U"] [", verbose ? Melder_integer (icol) : nullptr, U"]"); \
 				} \
 				texexdent (file); \
 			} \
@@ -334,12 +396,8 @@ bool NUMmatrix_equal (integer elementSize, void *m1, void *m2, integer row1, int
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void NUMmatrix_writeBinary_##storage (type **m, integer row1, integer row2, integer col1, integer col2, FILE *f) { \
-		if (row2 >= row1) { \
-			for (integer irow = row1; irow <= row2; irow ++) { \
-				for (integer icol = col1; icol <= col2; icol ++) \
-					binput##storage (m [irow] [icol], f); \
-			} \
-		} \
+		if (row2 >= row1 && col2 >= col1) \
+			NUMbinput_##storage (& m [row1] [col1], (row2 - row1 + 1) * (col2 - col1 + 1), f);   /* the rows are contiguous */ \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	type ** NUMmatrix_readText_##storage (integer row1, integer row2, integer col1, integer col2, MelderReadText text, const char *name) { \
@@ -362,9 +420,9 @@ bool NUMmatrix_equal (integer elementSize, void *m1, void *m2, integer row1, int
 	type ** NUMmatrix_readBinary_##storage (integer row1, integer row2, integer col1, integer col2, FILE *f) { \
 		type **result = nullptr; \
 		try { \
-			result = NUMmatrix <type> (row1, row2, col1, col2); \
-			for (integer irow = row1; irow <= row2; irow ++) for (integer icol = col1; icol <= col2; icol ++) \
-				result [irow] [icol] = binget##storage (f); \
+			result = NUMmatrix <type> (row1, row2, col1, col2, false); \
+			if (row2 >= row1 && col2 >= col1) \
+				NUMbinget_##storage (& result [row1] [col1], (row2 - row1 + 1) * (col2 - col1 + 1), f);   /* the rows are contiguous */ \
 			return result; \
 		} catch (MelderError) { \
 			NUMmatrix_free (result, row1, col1); \
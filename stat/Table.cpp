@@ -17,10 +17,12 @@
  */
 
 #include <ctype.h>
+#include <unordered_map>
 #include "Table.h"
 #include "NUM2.h"
 #include "Formula.h"
 #include "SSCP.h"
+#include "MelderThread.h"
 
 #include "oo_DESTROY.h"
 #include "Table_def.h"
@@ -45,6 +47,26 @@ Thing_implement (TableRow, Daata, 0);
 
 Thing_implement (Table, Daata, 0);
 
+Thing_implement (TableColumnIndex, Thing, 0);
+
+/*
+	Hashing of cell strings by content, for dictionary-encoding columns without copying the strings.
+	A null string counts as the empty string, as everywhere else in this file.
+*/
+struct TableStringHash {
+	size_t operator() (const char32 *string) const {
+		size_t hash = 2166136261u;   // FNV-1a
+		if (string) for (; *string != U'\0'; string ++) hash = (hash ^ (size_t) *string) * 16777619u;
+		return hash;
+	}
+};
+struct TableStringEqual {
+	bool operator() (const char32 *first, const char32 *second) const {
+		return str32equ (first ? first : U"", second ? second : U"");
+	}
+};
+typedef std::unordered_map <const char32 *, integer, TableStringHash, TableStringEqual> TableStringDictionary;
+
 void structTable :: v_info () {
 	our structDaata :: v_info ();
 	MelderInfo_writeLine (U"Number of rows: ", our rows.size);
@@ -131,6 +153,7 @@ void Table_appendRow (Table me) {
 	try {
 		autoTableRow row = TableRow_create (my numberOfColumns);
 		my rows. addItem_move (row.move());
+		Table_forgetColumnIndexes (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": row not appended.");
 	}
@@ -159,6 +182,7 @@ void Table_removeRow (Table me, integer rowNumber) {
 		my rows. removeItem (rowNumber);
 		for (integer icol = 1; icol <= my numberOfColumns; icol ++)
 			my columnHeaders [icol]. numericized = false;
+		Table_forgetColumnIndexes (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": row ", rowNumber, U" not removed.");
 	}
@@ -190,6 +214,7 @@ void Table_removeColumn (Table me, integer columnNumber) {
 			row -> numberOfColumns --;
 		}
 		my numberOfColumns --;
+		Table_forgetColumnIndexes (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": column ", Table_messageColumn (me, columnNumber), U" not removed.");
 	}
@@ -214,6 +239,7 @@ void Table_insertRow (Table me, integer rowNumber) {
 		 */
 		for (integer icol = 1; icol <= my numberOfColumns; icol ++)
 			my columnHeaders [icol]. numericized = false;
+		Table_forgetColumnIndexes (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": row ", rowNumber, U" not inserted.");
 	}
@@ -281,6 +307,7 @@ void Table_insertColumn (Table me, integer columnNumber, const char32 *label /*
 		 * Update my state.
 		 */
 		my numberOfColumns ++;
+		Table_forgetColumnIndexes (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": column not inserted.");
 	}
@@ -329,7 +356,67 @@ integer * Table_getColumnIndicesFromColumnLabelString (Table me, const char32 *s
 	return columns.transfer();
 }
 
+void Table_forgetColumnIndexes (Table me) noexcept {
+	my columnIndexes. clear ();
+}
+
+static void Table_forgetColumnIndex (Table me, integer columnNumber) noexcept {
+	if (columnNumber < (integer) my columnIndexes. size ())
+		my columnIndexes [(size_t) columnNumber]. reset ();
+}
+
+/*
+	The index of a column, built on first use. Returns null if there is no memory for it,
+	in which case the caller should scan the column.
+*/
+static TableColumnIndex Table_getColumnIndex (Table me, integer columnNumber) noexcept {
+	try {
+		if ((integer) my columnIndexes. size () <= columnNumber)
+			my columnIndexes. resize ((size_t) my numberOfColumns + 1);
+		autoTableColumnIndex& index = my columnIndexes [(size_t) columnNumber];
+		if (! index) {
+			autoTableColumnIndex newIndex = Thing_new (TableColumnIndex);
+			newIndex -> nextRowWithSameString. resize ((size_t) my rows.size + 1, 0);
+			for (integer irow = my rows.size; irow >= 1; irow --) {   // backwards, so that each chain starts at the first row
+				const char32 *string = my rows.at [irow] -> cells [columnNumber]. string;
+				if (! string) continue;
+				integer& firstRow = newIndex -> firstRowWithString [string];
+				newIndex -> nextRowWithSameString [(size_t) irow] = firstRow;
+				firstRow = irow;
+			}
+			index = newIndex.move();
+		}
+		return index.get();
+	} catch (...) {
+		Melder_clearError ();
+		Table_forgetColumnIndexes (me);
+		return nullptr;
+	}
+}
+
+/*
+	The first row whose cell in the column is the given string (not null), or 0; to be followed by Table_nextRowWithSameString_ ().
+*/
+static integer Table_firstRowWithString_ (TableColumnIndex index, const char32 *string) {
+	auto found = index -> firstRowWithString. find (string);
+	return found == index -> firstRowWithString. end () ? 0 : found -> second;
+}
+
+static integer Table_nextRowWithSameString_ (TableColumnIndex index, integer rowNumber) {
+	return index -> nextRowWithSameString [(size_t) rowNumber];
+}
+
 integer Table_searchColumn (Table me, integer columnNumber, const char32 *value) noexcept {
+	if (value) {
+		TableColumnIndex index = Table_getColumnIndex (me, columnNumber);
+		if (index) {
+			try {
+				return Table_firstRowWithString_ (index, value);
+			} catch (...) {
+				Melder_clearError ();   // out of memory while making a key; fall back to a scan
+			}
+		}
+	}
 	for (integer irow = 1; irow <= my rows.size; irow ++) {
 		TableRow row = my rows.at [irow];
 		if (row -> cells [columnNumber]. string && str32equ (row -> cells [columnNumber]. string, value))
@@ -353,6 +440,7 @@ void Table_setStringValue (Table me, integer rowNumber, integer columnNumber, co
 		Melder_free (row -> cells [columnNumber]. string);
 		row -> cells [columnNumber]. string = newValue.transfer();
 		my columnHeaders [columnNumber]. numericized = false;
+		Table_forgetColumnIndex (me, columnNumber);
 	} catch (MelderError) {
 		Melder_throw (me, U": string value not set.");
 	}
@@ -373,6 +461,7 @@ void Table_setNumericValue (Table me, integer rowNumber, integer columnNumber, d
 		Melder_free (row -> cells [columnNumber]. string);
 		row -> cells [columnNumber]. string = newValue.transfer();
 		my columnHeaders [columnNumber]. numericized = false;
+		Table_forgetColumnIndex (me, columnNumber);
 	} catch (MelderError) {
 		Melder_throw (me, U": numeric value not set.");
 	}
@@ -408,62 +497,52 @@ bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	return true;
 }
 
-static integer stringCompare_column;
-
-static int stringCompare_NoError (const void *first, const void *second) {
-	TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	char32 *firstString = my cells [stringCompare_column]. string;
-	char32 *secondString = thy cells [stringCompare_column]. string;
-	return str32cmp (firstString ? firstString : U"", secondString ? secondString : U"");
-}
-
-static void sortRowsByStrings_Assert (Table me, integer columnNumber) {
-	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
-	stringCompare_column = columnNumber;
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), stringCompare_NoError);
-}
-
-static int indexCompare_NoError (const void *first, const void *second) {
-	TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	if (my sortingIndex < thy sortingIndex) return -1;
-	if (my sortingIndex > thy sortingIndex) return +1;
-	return 0;
-}
-
-static void sortRowsByIndex_NoError (Table me) {
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), indexCompare_NoError);
+static int distinctStringCompare_NoError (const void *first, const void *second) {
+	return str32cmp (* (const char32 **) first, * (const char32 **) second);
 }
 
 void Table_numericize_Assert (Table me, integer columnNumber) {
 	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
 	if (my columnHeaders [columnNumber]. numericized) return;
-	if (Table_isColumnNumeric_ErrorFalse (me, columnNumber)) {
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			const char32 *string = row -> cells [columnNumber]. string;
-			row -> cells [columnNumber]. number =
-				! string || string [0] == U'\0' || (string [0] == U'?' && string [1] == U'\0') ? undefined :
-				Melder_atof (string);
+	/*
+		Check and convert in a single pass; a column turns out to be nominal at its first non-numeric cell.
+	*/
+	bool isNumeric = true;
+	for (integer irow = 1; irow <= my rows.size; irow ++) {
+		if (! Table_isCellNumeric_ErrorFalse (me, irow, columnNumber)) {
+			isNumeric = false;
+			break;
 		}
-	} else {
-		integer iunique = 0;
-		const char32 *previousString = nullptr;
+		TableRow row = my rows.at [irow];
+		const char32 *string = row -> cells [columnNumber]. string;
+		row -> cells [columnNumber]. number =
+			! string || string [0] == U'\0' || (string [0] == U'?' && string [1] == U'\0') ? undefined :
+			Melder_atof (string);
+	}
+	if (! isNumeric) {
+		/*
+			A nominal column is numbered by the rank of each distinct string in alphabetical order.
+			Collect the distinct strings in a dictionary and sort only those,
+			instead of sorting all the rows by their strings and back again.
+		*/
+		TableStringDictionary dictionary;
+		autoNUMvector <const char32 *> distinctStrings (1, my rows.size);
+		integer numberOfDistinctStrings = 0;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
+			const char32 *string = row -> cells [columnNumber]. string;
+			if (! string) string = U"";
+			if (dictionary. insert (std::make_pair (string, 0)). second)
+				distinctStrings [++ numberOfDistinctStrings] = string;
 		}
-		sortRowsByStrings_Assert (me, columnNumber);
+		if (numberOfDistinctStrings > 0)
+			qsort (& distinctStrings [1], (unsigned long) numberOfDistinctStrings, sizeof (const char32 *), distinctStringCompare_NoError);
+		for (integer istring = 1; istring <= numberOfDistinctStrings; istring ++)
+			dictionary [distinctStrings [istring]] = istring;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			TableRow row = my rows.at [irow];
-			const char32 *string = row -> cells [columnNumber]. string;
-			if (! string) string = U"";
-			if (! previousString || ! str32equ (string, previousString)) {
-				iunique ++;
-			}
-			row -> cells [columnNumber]. number = iunique;
-			previousString = string;
+			row -> cells [columnNumber]. number = dictionary [row -> cells [columnNumber]. string];
 		}
-		sortRowsByIndex_NoError (me);
 	}
 	my columnHeaders [columnNumber]. numericized = true;
 }
@@ -555,11 +634,22 @@ double Table_getGroupMean (Table me, integer columnNumber, integer groupColumnNu
 		Table_numericize_checkDefined (me, columnNumber);
 		integer n = 0;
 		longdouble sum = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (Melder_equ (row -> cells [groupColumnNumber]. string, group)) {
+		TableColumnIndex index = ( group && group [0] != U'\0' ? Table_getColumnIndex (me, groupColumnNumber) : nullptr );
+		if (index) {
+			/*
+				Visit only the rows of the group, in the same order as the scan below.
+			*/
+			for (integer irow = Table_firstRowWithString_ (index, group); irow != 0; irow = Table_nextRowWithSameString_ (index, irow)) {
 				n += 1;
-				sum += row -> cells [columnNumber]. number;
+				sum += my rows.at [irow] -> cells [columnNumber]. number;
+			}
+		} else {
+			for (integer irow = 1; irow <= my rows.size; irow ++) {
+				TableRow row = my rows.at [irow];
+				if (Melder_equ (row -> cells [groupColumnNumber]. string, group)) {
+					n += 1;
+					sum += row -> cells [columnNumber]. number;
+				}
 			}
 		}
 		if (n < 1) return undefined;
@@ -666,12 +756,21 @@ autoTable Table_extractRowsWhereColumn_string (Table me, integer columnNumber, k
 			autostring32 newLabel = Melder_dup (my columnHeaders [icol]. label);
 			thy columnHeaders [icol]. label = newLabel.transfer();
 		}
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (Melder_stringMatchesCriterion (row -> cells [columnNumber]. string, which, criterion, true)) {
-				autoTableRow newRow = Data_copy (row);
+		TableColumnIndex index = ( which == kMelder_string::EQUAL_TO && criterion && criterion [0] != U'\0' ?
+			Table_getColumnIndex (me, columnNumber) : nullptr );
+		if (index) {
+			for (integer irow = Table_firstRowWithString_ (index, criterion); irow != 0; irow = Table_nextRowWithSameString_ (index, irow)) {
+				autoTableRow newRow = Data_copy (my rows.at [irow]);
 				thy rows. addItem_move (newRow.move());
 			}
+		} else {
+			for (integer irow = 1; irow <= my rows.size; irow ++) {
+				TableRow row = my rows.at [irow];
+				if (Melder_stringMatchesCriterion (row -> cells [columnNumber]. string, which, criterion, true)) {
+					autoTableRow newRow = Data_copy (row);
+					thy rows. addItem_move (newRow.move());
+				}
+			}
 		}
 		if (thy rows.size == 0) {
 			Melder_warning (U"No row matches criterion.");
@@ -682,6 +781,144 @@ autoTable Table_extractRowsWhereColumn_string (Table me, integer columnNumber, k
 	}
 }
 
+inline static int compareKeys (const double *first, const double *second, integer numberOfKeys) {
+	for (integer ikey = 0; ikey < numberOfKeys; ikey ++) {
+		if (first [ikey] < second [ikey]) return -1;
+		if (first [ikey] > second [ikey]) return +1;
+	}
+	return 0;
+}
+
+/*
+	Sort row numbers stably by the numbers in the given columns, which have to be numericized.
+	The numbers are copied once into a packed array of keys, so that the comparisons
+	touch neither the rows nor any global state.
+*/
+static void Table_sortRowNumbers_Assert (Table me, integer *columns, integer numberOfColumns, integer *rowNumbers, integer numberOfRowNumbers) {
+	const integer n = numberOfRowNumbers, numberOfKeys = numberOfColumns;
+	if (n < 2 || numberOfKeys < 1) return;
+	autoNUMvector <double> keys (1, n * numberOfKeys);
+	for (integer i = 1; i <= n; i ++) {
+		TableRow row = my rows.at [rowNumbers [i]];
+		double *key = & keys [(i - 1) * numberOfKeys + 1];
+		for (integer icol = 1; icol <= numberOfKeys; icol ++)
+			key [icol - 1] = row -> cells [columns [icol]]. number;
+	}
+	/*
+		Bottom-up merge sort of the positions 1 .. n.
+		On ties, merging takes from the left run, which makes the sort stable.
+	*/
+	autoNUMvector <integer> order (1, n), buffer (1, n);
+	for (integer i = 1; i <= n; i ++)
+		order [i] = i;
+	integer *from = order.peek(), *to = buffer.peek();
+	for (integer width = 1; width < n; width *= 2) {
+		for (integer lo = 1; lo <= n; lo += 2 * width) {
+			integer mid = lo + width - 1, hi = lo + 2 * width - 1;
+			if (mid > n) mid = n;
+			if (hi > n) hi = n;
+			integer left = lo, right = mid + 1, out = lo;
+			while (left <= mid && right <= hi)
+				to [out ++] = compareKeys (& keys [(from [right] - 1) * numberOfKeys + 1], & keys [(from [left] - 1) * numberOfKeys + 1], numberOfKeys) < 0 ?
+					from [right ++] : from [left ++];
+			while (left <= mid)
+				to [out ++] = from [left ++];
+			while (right <= hi)
+				to [out ++] = from [right ++];
+		}
+		integer *swap = from; from = to; to = swap;
+	}
+	for (integer i = 1; i <= n; i ++)
+		to [i] = rowNumbers [from [i]];
+	for (integer i = 1; i <= n; i ++)
+		rowNumbers [i] = to [i];
+}
+
+/*
+	Hashing of rows by the numbers in some of their cells, for grouping rows without sorting them.
+*/
+struct TableRowCellsHash {
+	Table table;
+	integer *columns, numberOfColumns;
+	size_t operator() (integer rowNumber) const {
+		TableRow row = table -> rows.at [rowNumber];
+		size_t hash = 0;
+		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+			double number = row -> cells [columns [icol]]. number;
+			if (number == 0.0) number = 0.0;   // -0.0 has to end up in the same group as +0.0
+			hash = hash * 31 + std::hash <double> () (number);
+		}
+		return hash;
+	}
+};
+struct TableRowCellsEqual {
+	Table table;
+	integer *columns, numberOfColumns;
+	bool operator() (integer firstRowNumber, integer secondRowNumber) const {
+		TableRow firstRow = table -> rows.at [firstRowNumber], secondRow = table -> rows.at [secondRowNumber];
+		for (integer icol = 1; icol <= numberOfColumns; icol ++)
+			if (firstRow -> cells [columns [icol]]. number != secondRow -> cells [columns [icol]]. number)
+				return false;
+		return true;
+	}
+};
+
+/*
+	Divide the rows into groups that have equal numbers in the given columns, without changing the order of the rows.
+	The groups come in the order in which Table_sortRows_Assert would bring them, and within each group
+	the rows keep their order. On return, the rows of group igroup are
+	rowsInGroups [firstRowOfGroup [igroup]] .. rowsInGroups [firstRowOfGroup [igroup + 1] - 1].
+	The columns have to be numericized and defined.
+*/
+static integer Table_groupRows_Assert (Table me, integer *columns, integer numberOfColumns,
+	autoNUMvector <integer> *rowsInGroups, autoNUMvector <integer> *firstRowOfGroup)
+{
+	for (integer icol = 1; icol <= numberOfColumns; icol ++)
+		Table_numericize_Assert (me, columns [icol]);
+	const integer numberOfRows = my rows.size;
+	/*
+		Find the groups in one pass, numbering them in the order of their first row.
+	*/
+	TableRowCellsHash hash { me, columns, numberOfColumns };
+	TableRowCellsEqual equal { me, columns, numberOfColumns };
+	std::unordered_map <integer, integer, TableRowCellsHash, TableRowCellsEqual> groupOfFirstRow (16, hash, equal);
+	autoNUMvector <integer> groupOfRow (1, numberOfRows);
+	autoNUMvector <integer> firstRows (1, numberOfRows);
+	integer numberOfGroups = 0;
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		auto found = groupOfFirstRow. insert (std::make_pair (irow, numberOfGroups + 1));
+		if (found. second)
+			firstRows [++ numberOfGroups] = irow;
+		groupOfRow [irow] = found. first -> second;
+	}
+	/*
+		Sort only the first rows of the groups, in order to find the rank of each group.
+	*/
+	Table_sortRowNumbers_Assert (me, columns, numberOfColumns, firstRows.peek(), numberOfGroups);
+	autoNUMvector <integer> rankOfGroup (1, numberOfGroups);
+	for (integer irank = 1; irank <= numberOfGroups; irank ++)
+		rankOfGroup [groupOfRow [firstRows [irank]]] = irank;
+	/*
+		Distribute the rows over the groups (a counting sort, hence stable).
+	*/
+	firstRowOfGroup -> reset (1, numberOfGroups + 1);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		(*firstRowOfGroup) [rankOfGroup [groupOfRow [irow]]] ++;
+	integer offset = 1;
+	for (integer irank = 1; irank <= numberOfGroups + 1; irank ++) {
+		integer count = (*firstRowOfGroup) [irank];
+		(*firstRowOfGroup) [irank] = offset;
+		offset += count;
+	}
+	rowsInGroups -> reset (1, numberOfRows);
+	autoNUMvector <integer> fill (1, numberOfGroups);
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		integer irank = rankOfGroup [groupOfRow [irow]];
+		(*rowsInGroups) [(*firstRowOfGroup) [irank] + fill [irank] ++] = irow;
+	}
+	return numberOfGroups;
+}
+
 static void Table_columns_checkExist (Table me, char32 **columnNames, integer n) {
 	for (integer i = 1; i <= n; i ++) {
 		if (Table_findColumnIndexFromColumnLabel (me, columnNames [i]) == 0)
@@ -702,7 +939,6 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 	const char32 *columnsToAverage_string, const char32 *columnsToMedianize_string,
 	const char32 *columnsToAverageLogarithmically_string, const char32 *columnsToMedianizeLogarithmically_string)
 {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -803,54 +1039,25 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 			Table_numericize_checkDefined (me, columns [icol]);
 		}
 		/*
-		 * Remember the present sorting of the original table.
-		 * (This is safe: the sorting index may change only vacuously when numericizing.)
-		 * But this cannot be done before the previous block!
-		 */
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-		 * We will now sort the original table temporarily, by the factors (independent variables) only.
+		 * Group the rows by the factors (independent variables) only.
 		 */
-		Table_sortRows_Assert (me, columns.peek(), numberOfFactors);   /* This works only because the factors come first. */
-		originalChanged = true;
-		/*
-		 * Find stretches of identical factors.
-		 */
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size) break;
-				for (integer icol = 1; icol <= numberOfFactors; icol ++) {
-					if (my rows.at [rowmax] -> cells [columns [icol]]. number !=
-						my rows.at [rowmin] -> cells [columns [icol]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical) break;
-			}
-			rowmax --;
-			/*
-			 * We have the stretch.
-			 */
+		autoNUMvector <integer> rowsInGroups, firstRowOfGroup;
+		integer numberOfGroups = Table_groupRows_Assert (me, columns.peek(), numberOfFactors, & rowsInGroups, & firstRowOfGroup);   // this works only because the factors come first
+		for (integer igroup = 1; igroup <= numberOfGroups; igroup ++) {
+			integer rowmin = firstRowOfGroup [igroup], rowmax = firstRowOfGroup [igroup + 1] - 1;
 			Table_insertRow (thee.get(), thy rows.size + 1);
 			{
 				integer icol = 0;
 				for (integer i = 1; i <= numberOfFactors; i ++) {
 					++ icol;
 					Table_setStringValue (thee.get(), thy rows.size, icol,
-						my rows.at [rowmin] -> cells [columns [icol]]. string);
+						my rows.at [rowsInGroups [rowmin]] -> cells [columns [icol]]. string);
 				}
 				for (integer i = 1; i <= numberToSum; i ++) {
 					++ icol;
 					longdouble sum = 0.0;
 					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
+						sum += my rows.at [rowsInGroups [jrow]] -> cells [columns [icol]]. number;
 					}
 					Table_setNumericValue (thee.get(), thy rows.size, icol, (double) sum);
 				}
@@ -858,14 +1065,14 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 					++ icol;
 					double sum = 0.0;
 					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
+						sum += my rows.at [rowsInGroups [jrow]] -> cells [columns [icol]]. number;
 					}
 					Table_setNumericValue (thee.get(), thy rows.size, icol, sum / (rowmax - rowmin + 1));
 				}
 				for (integer i = 1; i <= numberToMedianize; i ++) {
 					++ icol;
 					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						sortingColumn [jrow] = my rows.at [jrow] -> cells [columns [icol]]. number;
+						sortingColumn [jrow] = my rows.at [rowsInGroups [jrow]] -> cells [columns [icol]]. number;
 					}
 					NUMsort_d (rowmax - rowmin + 1, & sortingColumn [rowmin - 1]);
 					double median = NUMquantile (rowmax - rowmin + 1, & sortingColumn [rowmin - 1], 0.5);
@@ -875,11 +1082,11 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 					++ icol;
 					longdouble sum = 0.0;
 					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+						double value = my rows.at [rowsInGroups [jrow]] -> cells [columns [icol]]. number;
 						if (value <= 0.0)
 							Melder_throw (
 								U"The cell in column \"", columnsToAverageLogarithmically [i],
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsInGroups [jrow], U" of ", me,
 								U" is not positive.\nCannot average logarithmically.");
 						sum += log (value);
 					}
@@ -888,11 +1095,11 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 				for (integer i = 1; i <= numberToMedianizeLogarithmically; i ++) {
 					++ icol;
 					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+						double value = my rows.at [rowsInGroups [jrow]] -> cells [columns [icol]]. number;
 						if (value <= 0.0)
 							Melder_throw (
 								U"The cell in column \"", columnsToMedianizeLogarithmically [i],
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsInGroups [jrow], U" of ", me,
 								U" is not positive.\nCannot medianize logarithmically.");
 						sortingColumn [jrow] = log (value);
 					}
@@ -902,49 +1109,24 @@ autoTable Table_collapseRows (Table me, const char32 *factors_string, const char
 				}
 				Melder_assert (icol == thy numberOfColumns);
 			}
-			irow = rowmax;
 		}
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
+		Melder_throw (me, U": rows not collapsed.");
 	}
 }
 
 static char32 ** _Table_getLevels (Table me, integer column, integer *numberOfLevels) {
-	try {
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		integer columns [2] = { 0, column };
-		Table_sortRows_Assert (me, columns, 1);
-		*numberOfLevels = 0;
-		integer irow = 1;
-		while (irow <= my rows.size) {
-			double value = my rows.at [irow] -> cells [column]. number;
-			(*numberOfLevels) ++;
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) { }
-		}
-		autostring32vector result (1, *numberOfLevels);
-		*numberOfLevels = 0;
-		irow = 1;
-		while (irow <= my rows.size) {
-			double value = my rows.at [irow] -> cells [column]. number;
-			result [++ *numberOfLevels] = Melder_dup (Table_getStringValue_Assert (me, irow, column));
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) { }
-		}
-		sortRowsByIndex_NoError (me);   // unsort the original table
-		return result.transfer();
-	} catch (MelderError) {
-		sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
-	}
+	integer columns [2] = { 0, column };
+	autoNUMvector <integer> rowsInGroups, firstRowOfGroup;
+	*numberOfLevels = Table_groupRows_Assert (me, columns, 1, & rowsInGroups, & firstRowOfGroup);
+	autostring32vector result (1, *numberOfLevels);
+	for (integer ilevel = 1; ilevel <= *numberOfLevels; ilevel ++)
+		result [ilevel] = Melder_dup (Table_getStringValue_Assert (me, rowsInGroups [firstRowOfGroup [ilevel]], column));
+	return result.transfer();
 }
 
 autoTable Table_rowsToColumns (Table me, const char32 *factors_string, integer columnToTranspose, const char32 *columnsToExpand_string) {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -1003,57 +1185,28 @@ autoTable Table_rowsToColumns (Table me, const char32 *factors_string, integer c
 			}
 		}
 		/*
-		 * Remember the present sorting of the original table.
-		 * (This is safe: the sorting index may change only vacuously when numericizing.)
-		 * But this cannot be done before the previous blocks that numericize!
-		 */
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-		 * We will now sort the original table temporarily, by the factors (independent variables) only.
+		 * Group the rows by the factors (independent variables) only.
 		 */
-		Table_sortRows_Assert (me, factorColumns.peek(), numberOfFactors);
-		originalChanged = true;
-		/*
-		 * Find stretches of identical factors.
-		 */
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size) break;
-				for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
-					if (my rows.at [rowmax] -> cells [factorColumns [ifactor]]. number !=
-						my rows.at [rowmin] -> cells [factorColumns [ifactor]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical) break;
-			}
+		autoNUMvector <integer> rowsInGroups, firstRowOfGroup;
+		integer numberOfGroups = Table_groupRows_Assert (me, factorColumns.peek(), numberOfFactors, & rowsInGroups, & firstRowOfGroup);
+		for (integer igroup = 1; igroup <= numberOfGroups; igroup ++) {
+			integer rowmin = firstRowOfGroup [igroup], rowmax = firstRowOfGroup [igroup + 1] - 1;
 			#if 0
-			if (rowmax - rowmin > numberOfLevels && ! warned) {
+			if (rowmax - rowmin + 1 > numberOfLevels && ! warned) {
 				Melder_warning (U"Some rows of the original table have not been included in the new table. "
 					U"You could perhaps add more factors.");
 				warned = true;
 			}
 			#endif
-			rowmax --;
-			/*
-			 * We have the stretch.
-			 */
 			Table_insertRow (thee.get(), thy rows.size + 1);
 			TableRow thyRow = thy rows.at [thy rows.size];
 			for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
 				Table_setStringValue (thee.get(), thy rows.size, ifactor,
-					my rows.at [rowmin] -> cells [factorColumns [ifactor]]. string);
+					my rows.at [rowsInGroups [rowmin]] -> cells [factorColumns [ifactor]]. string);
 			}
 			for (integer iexpand = 1; iexpand <= numberToExpand; iexpand ++) {
 				for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-					TableRow myRow = my rows.at [jrow];
+					TableRow myRow = my rows.at [rowsInGroups [jrow]];
 					double value = myRow -> cells [columnsToExpand [iexpand]]. number;
 					integer level = Melder_iround (myRow -> cells [columnToTranspose]. number);
 					integer thyColumn = numberOfFactors + (iexpand - 1) * numberOfLevels + level;
@@ -1065,13 +1218,10 @@ autoTable Table_rowsToColumns (Table me, const char32 *factors_string, integer c
 					Table_setNumericValue (thee.get(), thy rows.size, thyColumn, value);
 				}
 			}
-			irow = rowmax;
 		}
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
+		Melder_throw (me, U": rows not transposed to columns.");
 	}
 }
 
@@ -1092,24 +1242,21 @@ autoTable Table_transpose (Table me) {
 	}
 }
 
-static integer *cellCompare_columns, cellCompare_numberOfColumns;
-
-static int cellCompare_NoError (const void *first, const void *second) {
-	TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	for (integer icol = 1; icol <= cellCompare_numberOfColumns; icol ++) {
-		if (my cells [cellCompare_columns [icol]]. number < thy cells [cellCompare_columns [icol]]. number) return -1;
-		if (my cells [cellCompare_columns [icol]]. number > thy cells [cellCompare_columns [icol]]. number) return +1;
-	}
-	return 0;
-}
-
 void Table_sortRows_Assert (Table me, integer *columns, integer numberOfColumns) {
 	for (integer icol = 1; icol <= numberOfColumns; icol ++) {
 		Table_numericize_Assert (me, columns [icol]);
 	}
-	cellCompare_columns = columns;
-	cellCompare_numberOfColumns = numberOfColumns;
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), cellCompare_NoError);
+	const integer numberOfRows = my rows.size;
+	autoNUMvector <integer> rowNumbers (1, numberOfRows);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		rowNumbers [irow] = irow;
+	Table_sortRowNumbers_Assert (me, columns, numberOfColumns, rowNumbers.peek(), numberOfRows);
+	autoNUMvector <TableRow> sortedRows (1, numberOfRows);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		sortedRows [irow] = my rows.at [rowNumbers [irow]];
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		my rows.at [irow] = sortedRows [irow];
+	Table_forgetColumnIndexes (me);
 }
 
 void Table_sortRows_string (Table me, const char32 *columns_string) {
@@ -1137,6 +1284,7 @@ void Table_randomizeRows (Table me) noexcept {
 		my rows.at [irow] = my rows.at [jrow];
 		my rows.at [jrow] = tmp;
 	}
+	Table_forgetColumnIndexes (me);
 }
 
 void Table_reflectRows (Table me) noexcept {
@@ -1146,6 +1294,7 @@ void Table_reflectRows (Table me) noexcept {
 		my rows.at [irow] = my rows.at [jrow];
 		my rows.at [jrow] = tmp;
 	}
+	Table_forgetColumnIndexes (me);
 }
 
 autoTable Tables_append (OrderedOf<structTable>* me) {
@@ -1992,11 +2141,12 @@ autoTable Table_readFromTableFile (MelderFile file) {
 			TableRow row = my rows.at [irow];
 			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
 				while (*p == U' ' || *p == U'\t' || *p == U'\n') { Melder_assert (*p != U'\0'); p ++; }
-				static MelderString buffer { };
-				MelderString_empty (& buffer);
-				while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0') { MelderString_appendCharacter (& buffer, *p); p ++; }
-				row -> cells [icol]. string = Melder_dup_f (buffer.string);
-				MelderString_empty (& buffer);
+				const char32 *cellStart = p;
+				while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0') p ++;
+				char32 *cell = Melder_malloc_f (char32, p - cellStart + 1);
+				memcpy (cell, cellStart, (size_t) (p - cellStart) * sizeof (char32));
+				cell [p - cellStart] = U'\0';
+				row -> cells [icol]. string = cell;
 			}
 		}
 		return me;
@@ -2005,6 +2155,73 @@ autoTable Table_readFromTableFile (MelderFile file) {
 	}
 }
 
+/*
+	The cells are read in two parallel passes, with the allocation of the cells in between, in the main thread.
+	The first pass finds where each cell starts and how long it will be without its quotes;
+	the second pass copies the cells into the strings that the main thread has allocated.
+	The threads thus never allocate and never throw; faulty rows are reported back as row numbers.
+*/
+Thing_define (Table_readCells_Args, Thing) {
+	Table table;
+	const char32 **rowStarts;
+	integer firstRow, lastRow;
+	char32 separator;
+	bool interpretQuotes;
+	const char32 **cellStarts;   // base 1, by row and then by column; filled in the first pass
+	integer *cellLengths;   // the number of characters without the interpreted quotes; filled in the first pass
+	bool copying;   // false in the first pass, true in the second
+	integer incompleteRow, overfullRow;   // the first faulty row that this thread found in the first pass, or 0
+};
+Thing_implement (Table_readCells_Args, Thing, 0);
+
+static MelderThread_RETURN_TYPE Table_readCells (Table_readCells_Args me) {
+	Table table = my table;
+	const integer numberOfColumns = table -> numberOfColumns;
+	for (integer irow = my firstRow; irow <= my lastRow; irow ++) {
+		TableRow row = table -> rows.at [irow];
+		const integer cellOffset = (irow - 1) * numberOfColumns;
+		if (my copying) {
+			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+				const char32 *from = my cellStarts [cellOffset + icol];
+				char32 *cell = row -> cells [icol]. string, *to = cell;
+				const char32 *end = cell + my cellLengths [cellOffset + icol];
+				for (; to < end; from ++)
+					if (! my interpretQuotes || *from != U'\"')
+						*to ++ = *from;
+				*to = U'\0';
+			}
+			continue;
+		}
+		const char32 *p = my rowStarts [irow];
+		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+			my cellStarts [cellOffset + icol] = p;
+			integer numberOfQuotes = 0;
+			bool withinQuotes = false;
+			const char32 *cellStart = p;
+			while (*p != U'\0' && (withinQuotes || (*p != my separator && *p != U'\n'))) {
+				if (my interpretQuotes && *p == U'\"') {
+					withinQuotes = ! withinQuotes;
+					numberOfQuotes ++;
+				}
+				p ++;
+			}
+			my cellLengths [cellOffset + icol] = (p - cellStart) - numberOfQuotes;
+			if (*p == U'\0' || *p == U'\n') {
+				if (icol != numberOfColumns) {
+					my incompleteRow = irow;
+					MelderThread_RETURN;
+				}
+			} else if (icol == numberOfColumns) {
+				my overfullRow = irow;
+				MelderThread_RETURN;
+			} else {
+				p ++;   // skip the separator
+			}
+		}
+	}
+	MelderThread_RETURN;
+}
+
 autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 separator, bool interpretQuotes) {
 	try {
 		autostring32 string = MelderFile_readText (file);
@@ -2012,12 +2229,8 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 		/*
 			Kill final new-line symbols.
 	 	*/
-		for (int64 length = str32len (string.peek());
-		     length > 0 && string [length - 1] == U'\n';
-			 length = str32len (string.peek()))
-		{
+		for (int64 length = str32len (string.peek()); length > 0 && string [length - 1] == U'\n'; length --)
 			string [length - 1] = U'\0';
-		}
 
 		/*
 			Count columns.
@@ -2032,18 +2245,29 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 		}
 
 		/*
-			Count rows.
+			Count rows, and remember where each of them starts.
 	 	*/
+		const char32 *firstRowStart = p;
 		integer numberOfRows = 1;
 	 	{// scope
 			bool withinQuotes = false;
 			for (;;) {
 				char32 kar = *p++;
+				if (kar == U'\0') break;
 				if (interpretQuotes && kar == U'\"') withinQuotes = ! withinQuotes;
-				if (! withinQuotes) {
-					if (kar == U'\0') break;
-					if (kar == U'\n') numberOfRows ++;
-				}
+				if (! withinQuotes && kar == U'\n') numberOfRows ++;
+			}
+		}
+		autoNUMvector <const char32 *> rowStarts (1, numberOfRows);
+		p = rowStarts [1] = firstRowStart;
+	 	{// scope
+			integer irow = 1;
+			bool withinQuotes = false;
+			for (;;) {
+				char32 kar = *p++;
+				if (kar == U'\0') break;
+				if (interpretQuotes && kar == U'\"') withinQuotes = ! withinQuotes;
+				if (! withinQuotes && kar == U'\n') rowStarts [++ irow] = p;
 			}
 		}
 
@@ -2069,35 +2293,49 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 		}
 
 		/*
-			Read cells.
+			Read cells. Rows are independent once we know where they start,
+			so blocks of rows can be read in parallel.
 	 	*/
+		const integer numberOfRowsPerThread = 1000;
+		int numberOfThreads = (numberOfRows - 1) / numberOfRowsPerThread + 1;
+		const int numberOfProcessors = MelderThread_getNumberOfProcessors ();
+		if (numberOfThreads > numberOfProcessors) numberOfThreads = numberOfProcessors;
+		if (numberOfThreads > 16) numberOfThreads = 16;
+		if (numberOfThreads < 1) numberOfThreads = 1;
+		const integer rowsPerThread = (numberOfRows - 1) / numberOfThreads + 1;
+		autoNUMvector <const char32 *> cellStarts (1, numberOfRows * numberOfColumns);
+		autoNUMvector <integer> cellLengths (1, numberOfRows * numberOfColumns);
+		autoTable_readCells_Args args [16];
+		for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			args [ithread - 1] = Thing_new (Table_readCells_Args);
+			Table_readCells_Args thread = args [ithread - 1].get();
+			thread -> table = me.get();
+			thread -> rowStarts = rowStarts.peek();
+			thread -> firstRow = (ithread - 1) * rowsPerThread + 1;
+			thread -> lastRow = ithread == numberOfThreads ? numberOfRows : ithread * rowsPerThread;
+			thread -> separator = separator;
+			thread -> interpretQuotes = interpretQuotes;
+			thread -> cellStarts = cellStarts.peek();
+			thread -> cellLengths = cellLengths.peek();
+		}
+		MelderThread_run (Table_readCells, args, numberOfThreads);
+		for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			Table_readCells_Args thread = args [ithread - 1].get();
+			if (thread -> incompleteRow == numberOfRows)
+				Melder_throw (U"Last row incomplete.");
+			if (thread -> incompleteRow != 0)
+				Melder_throw (U"Row ", thread -> incompleteRow, U" incomplete.");
+			if (thread -> overfullRow != 0)
+				Melder_throw (U"Row ", thread -> overfullRow, U" has more than ", numberOfColumns, U" cells.");
+		}
 		for (integer irow = 1; irow <= numberOfRows; irow ++) {
 			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				MelderString_empty (& buffer);
-				bool withinQuotes = false;
-				while (*p != separator && *p != U'\n' && *p != U'\0' || withinQuotes) {
-					if (interpretQuotes && *p == U'\"') {
-						withinQuotes = ! withinQuotes;
-					} else {
-						MelderString_appendCharacter (& buffer, *p);
-					}
-					p ++;
-				}
-				if (*p == U'\0') {
-					if (irow != numberOfRows)
-						Melder_fatal (U"irow ", irow, U", nrow ", numberOfRows, U", icol ", icol, U", ncol ", numberOfColumns);
-					if (icol != numberOfColumns) Melder_throw (U"Last row incomplete.");
-				} else if (*p == U'\n') {
-					if (icol != numberOfColumns) Melder_throw (U"Row ", irow, U" incomplete.");
-					p ++;
-				} else {
-					Melder_assert (*p == separator);
-					p ++;
-				}
-				row -> cells [icol]. string = Melder_dup (buffer.string);   // BUG? could be null
-			}
+			for (integer icol = 1; icol <= numberOfColumns; icol ++)
+				row -> cells [icol]. string = Melder_malloc (char32, cellLengths [(irow - 1) * numberOfColumns + icol] + 1);
 		}
+		for (int ithread = 1; ithread <= numberOfThreads; ithread ++)
+			args [ithread - 1] -> copying = true;
+		MelderThread_run (Table_readCells, args, numberOfThreads);
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from character-separated text file ", file, U".");
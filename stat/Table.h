@@ -18,10 +18,22 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "Collection.h"
 #include "Graphics.h"
 Thing_declare (Interpreter);
 
+/*
+	For one column, the rows in which each (non-null) string occurs, in ascending order.
+	Built lazily by the searching functions; forgotten whenever the column or the order of the rows changes.
+*/
+Thing_define (TableColumnIndex, Thing) {
+	std::unordered_map <std::u32string, integer> firstRowWithString;
+	std::vector <integer> nextRowWithSameString;   // 0 after the last row with the same string
+};
+
 #include "Table_def.h"
 
 void Table_initWithColumnNames (Table me, integer numberOfRows, const char32 *columnNames);
@@ -46,6 +58,8 @@ integer Table_findColumnIndexFromColumnLabel (Table me, const char32 *label) noe
 integer Table_getColumnIndexFromColumnLabel (Table me, const char32 *columnLabel);
 integer * Table_getColumnIndicesFromColumnLabelString (Table me, const char32 *string, integer *numberOfTokens);
 integer Table_searchColumn (Table me, integer column, const char32 *value) noexcept;
+void Table_forgetColumnIndexes (Table me) noexcept;
+	/* Needed after changing cells or the order of the rows without the functions of this interface. */
 
 /*
  * Procedure for reading strings or numbers from table cells:
@@ -65,6 +65,8 @@ oo_DEFINE_CLASS (Table, Daata)
 	oo_COLLECTION_OF (OrderedOf, rows, TableRow, 0)
 
 	#if oo_DECLARING
+		std::vector <autoTableColumnIndex> columnIndexes;   // [columnNumber], see Table_searchColumn
+
 		void v_info ()
 			override;
 		bool v_hasGetNrow ()
@@ -150,11 +150,28 @@ void Data_writeBinary (Daata me, FILE *f) {
 		Melder_throw (U"I/O error.");
 }
 
+/*
+	Binary files consist of many small items (numbers, strings) interspersed with large arrays.
+	A stdio buffer much larger than the default (which is typically 4 or 8 kilobytes)
+	saves most of the system calls for the small items, whereas large array transfers
+	(see bingetr64array and the like) bypass the buffer anyway.
+	The buffer has to stay alive until the file has been closed.
+*/
+#define Data_BINARY_FILE_BUFFER_SIZE  (1 << 20)
+
+static void Data_setBinaryFileBuffer (FILE *f, autoNUMvector <char> *buffer) {
+	if (f == stdout) return;
+	buffer -> reset (1, Data_BINARY_FILE_BUFFER_SIZE, false);
+	(void) setvbuf (f, & (*buffer) [1], _IOFBF, Data_BINARY_FILE_BUFFER_SIZE);   // no harm if this fails
+}
+
 void Data_writeToBinaryFile (Daata me, MelderFile file) {
 	try {
 		if (! Data_canWriteBinary (me))
 			Melder_throw (U"Objects of class ", my classInfo -> className, U" cannot be written to a generic binary file.");
+		autoNUMvector <char> buffer;   // declared before the file, so that it outlives it
 		autoMelderFile mfile = MelderFile_create (file);
+		Data_setBinaryFileBuffer (file -> filePointer, & buffer);
 		if (fprintf (file -> filePointer, "ooBinaryFile") < 0)
 			Melder_throw (U"Cannot write first bytes of file.");
 		binputw8 (
@@ -237,7 +254,9 @@ void Data_readBinary (Daata me, FILE *f, int formatVersion) {
 
 autoDaata Data_readFromBinaryFile (MelderFile file) {
 	try {
+		autoNUMvector <char> buffer;   // declared before the file, so that it outlives it
 		autofile f = Melder_fopen (file, "rb");
+		Data_setBinaryFileBuffer (f, & buffer);
 		char line [200];
 		size_t n = fread (line, 1, 199, f); line [n] = '\0';
 		/*
@@ -33,14 +33,16 @@
 #include "UiPause.h"
 #include "DemoEditor.h"
 
-static Interpreter theInterpreter;
-static autoInterpreter theLocalInterpreter;
-static Daata theSource;
-static const char32 *theExpression;
-static int theLevel = 1;
-#define MAXIMUM_NUMBER_OF_LEVELS  20
-static int theExpressionType [1 + MAXIMUM_NUMBER_OF_LEVELS];
-static bool theOptimize;
+/*
+	All the state of the compiler and of the evaluator is per thread, so that compiling or running a formula
+	in one thread does not disturb a formula in another. This does not make formulas thread-safe as a whole:
+	Melder_throw, the random-number functions and the Interpreter variables are shared.
+*/
+static thread_local Interpreter theInterpreter;
+static thread_local autoInterpreter theLocalInterpreter;
+static thread_local Daata theSource;
+static thread_local const char32 *theExpression;
+static thread_local bool theOptimize;
 
 typedef struct structFormulaInstruction {
 	int symbol;
@@ -55,8 +57,40 @@ typedef struct structFormulaInstruction {
 	} content;
 } *FormulaInstruction;
 
-static FormulaInstruction lexan, parse;
-static int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+static thread_local FormulaInstruction lexan, parse;
+static thread_local int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+
+/*
+	A formula can be compiled and run while another formula is running,
+	e.g. by `evaluate ()`, or by a script that is called with `runScript ()`.
+	Each nesting depth therefore has its own compiler buffers and its own evaluation stack.
+*/
+#define MAXIMUM_FORMULA_DEPTH  50
+struct FormulaDepth {
+	FormulaInstruction lexan, parse;   // the buffers of the compiler; `parse` holds the compiled program
+	int numberOfInstructions, numberOfStringConstants;
+	Interpreter interpreter;
+	Daata source;
+	int expressionType;
+	bool optimize;
+	Stackel stack;
+};
+static void FormulaInstructions_freeStrings (FormulaInstruction f);
+struct FormulaThreadState {
+	FormulaDepth depths [1 + MAXIMUM_FORMULA_DEPTH];   // depth 0 is outside any running formula
+	~FormulaThreadState () {
+		for (int idepth = 0; idepth <= MAXIMUM_FORMULA_DEPTH; idepth ++) {
+			FormulaDepth *depth = & depths [idepth];
+			if (depth -> lexan && depth -> numberOfStringConstants)
+				FormulaInstructions_freeStrings (depth -> lexan);
+			Melder_free (depth -> lexan);
+			Melder_free (depth -> parse);
+			Melder_free (depth -> stack);
+		}
+	}
+};
+static thread_local FormulaThreadState theFormulaThreadState;
+static thread_local int theFormulaDepth;   // the number of formulas that are running in this thread
 
 enum { GEENSYMBOOL_,
 
@@ -195,6 +229,7 @@ enum { GEENSYMBOOL_,
 	MATRIKS0_, MATRIKSSTR0_, MATRIKS1_, MATRIKSSTR1_, MATRIKS2_, MATRIKSSTR2_,
 	FUNKTIE0_, FUNKTIESTR0_, FUNKTIE1_, FUNKTIESTR1_, FUNKTIE2_, FUNKTIESTR2_,
 	SQR_,
+	ADD_NUMBER_, SUB_NUMBER_, MUL_NUMBER_, RDIV_NUMBER_,
 
 /* Symbols introduced by lexical analysis. */
 
@@ -292,6 +327,7 @@ static const char32 *Formula_instructionNames [1 + hoogsteSymbool] = { U"",
 	U"_matriks0", U"_matriks0$", U"_matriks1", U"_matriks1$", U"_matriks2", U"_matriks2$",
 	U"_funktie0", U"_funktie0$", U"_funktie1", U"_funktie1$", U"_funktie2", U"_funktie2$",
 	U"_square",
+	U"_addNumber", U"_subNumber", U"_mulNumber", U"_rdivNumber",
 	U"_string",
 	U"a numeric variable", U"a vector variable", U"a matrix variable",
 	U"a string variable", U"a string array variable",
@@ -304,12 +340,12 @@ static const char32 *Formula_instructionNames [1 + hoogsteSymbool] = { U"",
 #define oudlees  (-- ilexan)
 
 static void formulefout (const char32 *message, int position) {
-	static MelderString truncatedExpression { };
+	static thread_local autoMelderString truncatedExpression;
 	MelderString_ncopy (& truncatedExpression, theExpression, position + 1);
 	Melder_throw (message, U":\n" U_LEFT_GUILLEMET U" ", truncatedExpression.string);
 }
 
-static const char32 *languageNameCompare_searchString;
+static thread_local const char32 *languageNameCompare_searchString;
 
 static int languageNameCompare (const void *first, const void *second) {
 	int i = * (int *) first, j = * (int *) second;
@@ -317,15 +353,17 @@ static int languageNameCompare (const void *first, const void *second) {
 		j == 0 ? languageNameCompare_searchString : Formula_instructionNames [j]);
 }
 
-static int Formula_hasLanguageName (const char32 *f) {
-	static int *index;
-	if (! index) {
-		index = NUMvector <int> (1, hoogsteInvoersymbool);
-		for (int tok = 1; tok <= hoogsteInvoersymbool; tok ++) {
-			index [tok] = tok;
-		}
-		qsort (& index [1], hoogsteInvoersymbool, sizeof (int), languageNameCompare);
+static int *Formula_sortLanguageNames () {
+	int *index = NUMvector <int> (1, hoogsteInvoersymbool);
+	for (int tok = 1; tok <= hoogsteInvoersymbool; tok ++) {
+		index [tok] = tok;
 	}
+	qsort (& index [1], hoogsteInvoersymbool, sizeof (int), languageNameCompare);
+	return index;
+}
+
+static int Formula_hasLanguageName (const char32 *f) {
+	static int *index = Formula_sortLanguageNames ();   // sorted only once, even if several threads get here at the same time
 	if (! index) {   // linear search
 		for (int tok = 1; tok <= hoogsteInvoersymbool; tok ++) {
 			if (str32equ (f, Formula_instructionNames [tok])) return tok;
@@ -863,7 +901,7 @@ static void pas (int symbol) {
 		const char32 *symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
 		bool needQuotes1 = ! str32chr (symbolName1, U' ');
 		bool needQuotes2 = ! str32chr (symbolName2, U' ');
-		static MelderString melding { };
+		static thread_local autoMelderString melding;
 		MelderString_copy (& melding,
 			U"Expected ", ( needQuotes1 ? U"\"" : nullptr ), symbolName1, ( needQuotes1 ? U"\"" : nullptr ),
 			U", but found ", ( needQuotes2 ? U"\"" : nullptr ), symbolName2, ( needQuotes2 ? U"\"" : nullptr ));
@@ -877,7 +915,7 @@ static bool pasArguments () {
     if (symbol == COLON_) return false;   // success: a function call like: myFunction: ...
     const char32 *symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
     bool needQuotes2 = ! str32chr (symbolName2, U' ');
-    static MelderString melding { };
+    static thread_local autoMelderString melding;
     MelderString_copy (& melding,
 		U"Expected \"(\" or \":\", but found ", ( needQuotes2 ? U"\"" : nullptr ), symbolName2, ( needQuotes2 ? U"\"" : nullptr ));
     formulefout (melding.string, lexan [ilexan]. position);
@@ -1992,6 +2030,28 @@ static void Formula_evaluateConstants () {
 						{ gain = 2; parse [i]. content.number *= parse [i + 1]. content.number; }
 					else if (parse [i + 2]. symbol == RDIV_)
 						{ gain = 2; parse [i]. content.number /= parse [i + 1]. content.number; }
+				} else if (parse [i + 1]. symbol == ADD_NUMBER_)
+					{ gain = 1; parse [i]. content.number += parse [i + 1]. content.number; }
+				else if (parse [i + 1]. symbol == SUB_NUMBER_)
+					{ gain = 1; parse [i]. content.number -= parse [i + 1]. content.number; }
+				else if (parse [i + 1]. symbol == MUL_NUMBER_)
+					{ gain = 1; parse [i]. content.number *= parse [i + 1]. content.number; }
+				else if (parse [i + 1]. symbol == RDIV_NUMBER_)
+					{ gain = 1; parse [i]. content.number /= parse [i + 1]. content.number; }
+				else if (parse [i + 1]. symbol == ADD_ || parse [i + 1]. symbol == SUB_ ||
+				         parse [i + 1]. symbol == MUL_ || parse [i + 1]. symbol == RDIV_)
+				{
+					/*
+						A constant right operand: fuse the push and the operation into one instruction,
+						so that e.g. "self * 2 + 1" runs as SELF0_ MUL_NUMBER_ ADD_NUMBER_.
+						The constant is stored as pushNumber () would have pushed it.
+					*/
+					int operation = parse [i + 1]. symbol;
+					double number = parse [i]. content.number;
+					parse [i]. symbol = operation == ADD_ ? ADD_NUMBER_ : operation == SUB_ ? SUB_NUMBER_ :
+						operation == MUL_ ? MUL_NUMBER_ : RDIV_NUMBER_;
+					parse [i]. content.number = isdefined (number) ? number : undefined;
+					gain = 1;
 				} else if (parse [i + 1]. symbol == TO_OBJECT_) {
 					parse [i]. symbol = OBJECT_;
 					int IOBJECT = praat_findObjectById (Melder_iround (parse [i]. content.number));
@@ -2079,7 +2139,7 @@ static void Formula_print (FormulaInstruction f) {
 		const char32 *instructionName;
 		symbol = f [++ i]. symbol;
 		instructionName = Formula_instructionNames [symbol];
-		if (symbol == NUMBER_)
+		if (symbol == NUMBER_ || symbol == ADD_NUMBER_ || symbol == SUB_NUMBER_ || symbol == MUL_NUMBER_ || symbol == RDIV_NUMBER_)
 			Melder_casual (i, U" ", instructionName, U" ", f [i]. content.number);
 		else if (symbol == GOTO_ || symbol == IFFALSE_ || symbol == IFTRUE_ || symbol == LABEL_ || symbol == INCREMENT_GREATER_GOTO_)
 			Melder_casual (i, U" ", instructionName, U" ", f [i]. content.label);
@@ -2106,7 +2166,20 @@ static void Formula_print (FormulaInstruction f) {
 	} while (symbol != END_);
 }
 
-void Formula_compile (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize) {
+static void FormulaInstructions_freeStrings (FormulaInstruction f) {
+	for (int i = 1; ; i ++) {
+		int symbol = f [i]. symbol;
+		if (symbol == STRING_ || symbol == VARIABLE_NAME_ || symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_ || symbol == CALL_) Melder_free (f [i]. content.string);
+		else if (symbol == END_) break;   // either the end of a formula, or the end of lexan
+	}
+}
+
+static void Formula_compile_ (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize) {
+	FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth];
+	lexan = depth -> lexan;
+	parse = depth -> parse;
+	numberOfStringConstants = depth -> numberOfStringConstants;
+	depth -> numberOfInstructions = 0;   // in case compilation fails
 	theInterpreter = interpreter;
 	if (! theInterpreter) {
 		if (! theLocalInterpreter) {
@@ -2121,30 +2194,29 @@ void Formula_compile (Interpreter interpreter, Daata data, const char32 *express
 	}
 	theSource = data;
 	theExpression = expression;
-	theExpressionType [theLevel] = expressionType;
 	theOptimize = optimize;
 	if (! lexan) {
-		lexan = Melder_calloc_f (struct structFormulaInstruction, 3000);
+		lexan = depth -> lexan = Melder_calloc_f (struct structFormulaInstruction, 3000);
 		lexan [3000 - 1]. symbol = END_;   // make sure that cleaning up always terminates
 	}
-	if (! parse) parse = Melder_calloc_f (struct structFormulaInstruction, 3000);
+	if (! parse) parse = depth -> parse = Melder_calloc_f (struct structFormulaInstruction, 3000);
 
 	/*
 		Clean up strings from the previous call.
 		These strings are in a union, that's why this cannot be done later, when a new string is created.
 	*/
 	if (numberOfStringConstants) {
-		ilexan = 1;
-		for (;;) {
-			int symbol = lexan [ilexan]. symbol;
-			if (symbol == STRING_ || symbol == VARIABLE_NAME_ || symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_ || symbol == CALL_) Melder_free (lexan [ilexan]. content.string);
-			else if (symbol == END_) break;   // either the end of a formula, or the end of lexan
-			ilexan ++;
-		}
-		numberOfStringConstants = 0;
+		FormulaInstructions_freeStrings (lexan);
+		numberOfStringConstants = depth -> numberOfStringConstants = 0;
 	}
 
-	Formula_lexan ();
+	try {
+		Formula_lexan ();
+	} catch (MelderError) {
+		depth -> numberOfStringConstants = numberOfStringConstants;   // so that they will be cleaned up next time
+		throw;
+	}
+	depth -> numberOfStringConstants = numberOfStringConstants;
 	if (Melder_debug == 17) Formula_print (lexan);
 	Formula_parseExpression ();
 	if (Melder_debug == 17) Formula_print (parse);
@@ -2156,13 +2228,42 @@ void Formula_compile (Interpreter interpreter, Daata data, const char32 *express
 	}
 	Formula_removeLabels ();
 	if (Melder_debug == 17) Formula_print (parse);
+	depth -> numberOfInstructions = numberOfInstructions;
+	depth -> interpreter = theInterpreter;
+	depth -> source = data;
+	depth -> expressionType = expressionType;
+	depth -> optimize = optimize;
+}
+
+void Formula_compile (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize) {
+	/*
+		Leave the state of a formula that is running (we may have been called from `evaluate ()`) as it was.
+	*/
+	Interpreter savedInterpreter = theInterpreter;
+	Daata savedSource = theSource;
+	const char32 *savedExpression = theExpression;
+	bool savedOptimize = theOptimize;
+	try {
+		Formula_compile_ (interpreter, data, expression, expressionType, optimize);
+	} catch (MelderError) {
+		theInterpreter = savedInterpreter;
+		theSource = savedSource;
+		theExpression = savedExpression;
+		theOptimize = savedOptimize;
+		throw;
+	}
+	theInterpreter = savedInterpreter;
+	theSource = savedSource;
+	theExpression = savedExpression;
+	theOptimize = savedOptimize;
 }
 
 /*
  * Running.
  */
 
-static int programPointer;
+static thread_local FormulaInstruction theProgram;   // the program that is running
+static thread_local int theProgramLength, programPointer;
 
 static void Stackel_cleanUp (Stackel me) {
 	if (my which == Stackel_STRING) {
@@ -2179,8 +2280,8 @@ static void Stackel_cleanUp (Stackel me) {
 		my numericMatrix = empty_nummat;
 	}
 }
-static Stackel theStack;
-static integer w, wmax;   /* w = stack pointer; */
+static thread_local Stackel theStack;
+static thread_local integer w, wmax;   /* w = stack pointer; */
 #define pop  & theStack [w --]
 #define topOfStack  & theStack [w]
 inline static void pushNumber (double x) {
@@ -3071,7 +3172,7 @@ static void do_function_n_n (double (*f) (double)) {
 	if (x->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) ? undefined : f (x->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric argument, not ", Stackel_whichText (x), U".");
 	}
 }
@@ -3093,7 +3194,7 @@ static void do_functionvec_n_n (double (*f) (double)) {
 			x->owned = true;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric vector argument, not ", Stackel_whichText (x), U".");
 	}
 }
@@ -3123,7 +3224,7 @@ static void do_softmax () {
 			x->numericVector [i] /= (double) sum;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a numeric vector argument, not ", Stackel_whichText (x), U".");
 	}
 }
@@ -3364,7 +3465,7 @@ static void do_function_dd_d (double (*f) (double, double)) {
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined : f (x->number, y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3373,7 +3474,7 @@ static void do_function_dd_d_numvec (double (*f) (double, double)) {
 	Stackel n = pop;
 	Melder_assert (n -> which == Stackel_NUMBER);
 	if (n -> number != 3)
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		integer numberOfElements = ( a->which == Stackel_NUMBER ? a->number : a->numericVector.size );
@@ -3383,7 +3484,7 @@ static void do_function_dd_d_numvec (double (*f) (double, double)) {
 		}
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			Stackel_whichText (a), U", ", Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3392,7 +3493,7 @@ static void do_function_dd_d_nummat (double (*f) (double, double)) {
 	Stackel n = pop;
 	Melder_assert (n -> which == Stackel_NUMBER);
 	if (n -> number != 3)
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if (a->which == Stackel_NUMERIC_MATRIX && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		integer numberOfRows = a->numericMatrix.nrow;
@@ -3405,7 +3506,7 @@ static void do_function_dd_d_nummat (double (*f) (double, double)) {
 		}
 		pushNumericMatrix (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires one matrix argument and two numeric arguments, not ",
 			Stackel_whichText (a), U", ", Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3414,7 +3515,7 @@ static void do_function_ll_l_numvec (integer (*f) (integer, integer)) {
 	Stackel n = pop;
 	Melder_assert (n -> which == Stackel_NUMBER);
 	if (n -> number != 3)
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER) {
 		integer numberOfElements = ( a->which == Stackel_NUMBER ? a->number : a->numericVector.size );
@@ -3424,7 +3525,7 @@ static void do_function_ll_l_numvec (integer (*f) (integer, integer)) {
 		}
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			Stackel_whichText (a), U", ", Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3433,7 +3534,7 @@ static void do_function_ll_l_nummat (integer (*f) (integer, integer)) {
 	Stackel n = pop;
 	Melder_assert (n -> which == Stackel_NUMBER);
 	if (n -> number != 3)
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if (a->which == Stackel_NUMERIC_MATRIX && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		integer numberOfRows = a->numericMatrix.nrow;
@@ -3446,7 +3547,7 @@ static void do_function_ll_l_nummat (integer (*f) (integer, integer)) {
 		}
 		pushNumericMatrix (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires one matrix argument and two numeric arguments, not ",
 			Stackel_whichText (a), U", ", Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3457,7 +3558,7 @@ static void do_function_dl_d (double (*f) (double, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (x->number, Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3468,7 +3569,7 @@ static void do_function_ld_d (double (*f) (integer, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3479,7 +3580,7 @@ static void do_function_ll_l (integer (*f) (integer, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			Stackel_whichText (x), U" and ", Stackel_whichText (y), U".");
 	}
@@ -3508,7 +3609,7 @@ static void do_function_ddd_d (double (*f) (double, double, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) || isundef (z->number) ? undefined :
 			f (x->number, y->number, z->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires three numeric arguments, not ", Stackel_whichText (x), U", ",
 			Stackel_whichText (y), U", and ", Stackel_whichText (z), U".");
 	}
@@ -3863,14 +3964,7 @@ static void do_runScript () {
 	Stackel fileName = & theStack [w + 1];
 	if (fileName->which != Stackel_STRING)
 		Melder_throw (U"The first argument to \"runScript\" has to be a string (the file name), not ", Stackel_whichText (fileName));
-	theLevel += 1;
-	try {
-		praat_executeScriptFromFileName (fileName->string, numberOfArguments - 1, & theStack [w + 1]);
-		theLevel -= 1;
-	} catch (MelderError) {
-		theLevel -= 1;
-		throw;
-	}
+	praat_executeScriptFromFileName (fileName->string, numberOfArguments - 1, & theStack [w + 1]);
 	pushNumber (1);
 }
 static void do_runSystem () {
@@ -4211,7 +4305,7 @@ static void do_numberOfRows () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.nrow);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a matrix argument, not ", Stackel_whichText (array), U".");
 	}
 }
@@ -4224,7 +4318,7 @@ static void do_numberOfColumns () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.ncol);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U" requires a matrix argument, not ", Stackel_whichText (array), U".");
 	}
 }
@@ -4269,7 +4363,7 @@ static void do_hash () {
 }
 
 static void do_numericVectorElement () {
-	InterpreterVariable vector = parse [programPointer]. content.variable;
+	InterpreterVariable vector = theProgram [programPointer]. content.variable;
 	integer element = 1;   // default
 	Stackel r = pop;
 	if (r -> which != Stackel_NUMBER)
@@ -4284,7 +4378,7 @@ static void do_numericVectorElement () {
 	pushNumber (vector -> numericVectorValue [element]);
 }
 static void do_numericMatrixElement () {
-	InterpreterVariable matrix = parse [programPointer]. content.variable;
+	InterpreterVariable matrix = theProgram [programPointer]. content.variable;
 	integer row = 1, column = 1;   // default
 	Stackel c = pop;
 	if (c -> which != Stackel_NUMBER)
@@ -4314,8 +4408,8 @@ static void do_indexedNumericVariable () {
 	integer nindex = Melder_iround (n -> number);
 	if (nindex < 1)
 		Melder_throw (U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName { };
+	char32 *indexedVariableName = theProgram [programPointer]. content.string;
+	static thread_local autoMelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
 	w -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
@@ -4339,8 +4433,8 @@ static void do_indexedStringVariable () {
 	integer nindex = Melder_iround (n -> number);
 	if (nindex < 1)
 		Melder_throw (U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName { };
+	char32 *indexedVariableName = theProgram [programPointer]. content.string;
+	static thread_local autoMelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
 	w -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
@@ -4545,7 +4639,7 @@ static void do_stringMatchesCriterion (kMelder_string criterion) {
 		int result = Melder_stringMatchesCriterion (s->string, criterion, t->string, true);
 		pushNumber (result);
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"\" requires two strings, not ", Stackel_whichText (s), U" and ", Stackel_whichText (t), U".");
 	}
 }
@@ -4566,7 +4660,7 @@ static void do_index_regex (int backward) {
 			}
 		}
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"\" requires two strings, not ", Stackel_whichText (s), U" and ", Stackel_whichText (t), U".");
 	}
 }
@@ -4639,7 +4733,7 @@ static void do_extractNumber () {
 			}
 		}
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"\" requires two strings, not ", Stackel_whichText (s), U" and ", Stackel_whichText (t), U".");
 	}
 }
@@ -4673,7 +4767,7 @@ static void do_extractTextStr (bool singleWord) {
 		}
 		pushString (result.transfer());
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theProgram [programPointer]. symbol],
 			U"\" requires two strings, not ", Stackel_whichText (s), U" and ", Stackel_whichText (t), U".");
 	}
 }
@@ -6052,7 +6146,7 @@ static void do_objectCell0 (integer irow, integer icol) {
 	}
 }
 static void do_matriks0 (integer irow, integer icol) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	if (thy v_hasGetCell ()) {
 		pushNumber (thy v_getCell ());
 	} else if (thy v_hasGetVector ()) {
@@ -6140,7 +6234,7 @@ static void do_objectCell1 (integer irow) {
 	}
 }
 static void do_matriks1 (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel column = pop;
 	integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVector ()) {
@@ -6178,7 +6272,7 @@ static void do_objectCellStr1 (integer irow) {
 	}
 }
 static void do_matrixStr1 (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel column = pop;
 	integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVectorStr ()) {
@@ -6228,7 +6322,7 @@ static void do_objectCell2 () {
 	pushNumber (thy v_getMatrix (irow, icol));
 }
 static void do_matriks2 () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel column = pop, row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	integer icol = Stackel_getColumnNumber (column, thee);
@@ -6247,7 +6341,7 @@ static void do_objectCellStr2 () {
 	pushString (result.transfer());
 }
 static void do_matriksStr2 () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel column = pop, row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	integer icol = Stackel_getColumnNumber (column, thee);
@@ -6296,7 +6390,7 @@ static void do_objectLocation0 (integer irow, integer icol) {
 	}
 }
 static void do_funktie0 (integer irow, integer icol) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	if (thy v_hasGetFunction0 ()) {
 		pushNumber (thy v_getFunction0 ());
 	} else if (thy v_hasGetFunction1 ()) {
@@ -6379,7 +6473,7 @@ static void do_objectLocation1 (integer irow) {
 	}
 }
 static void do_funktie1 (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel x = pop;
 	if (x->which == Stackel_NUMBER) {
 		if (thy v_hasGetFunction1 ()) {
@@ -6427,7 +6521,7 @@ static void do_objectLocation2 () {
 	}
 }
 static void do_funktie2 () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel y = pop, x = pop;
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		if (! thy v_hasGetFunction2 ())
@@ -6438,7 +6532,7 @@ static void do_funktie2 () {
 	}
 }
 static void do_rowStr () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	autostring32 result = Melder_dup (thy v_getRowStr (irow));
@@ -6447,7 +6541,7 @@ static void do_rowStr () {
 	pushString (result.transfer());
 }
 static void do_colStr () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theProgram [programPointer]. content.object;
 	Stackel col = pop;
 	integer icol = Stackel_getColumnNumber (col, thee);
 	autostring32 result = Melder_dup (thy v_getColStr (icol));
@@ -6469,15 +6563,12 @@ static double NUMerf (double x) {
 	return 1.0 - NUMerfcc (x);
 }
 
-void Formula_run (integer row, integer col, Formula_Result *result) {
-	FormulaInstruction f = parse;
+static void Formula_run_ (integer row, integer col, int expressionType, Formula_Result *result) {
+	FormulaInstruction f = theProgram;
 	programPointer = 1;   // first symbol of the program
-	if (! theStack) theStack = Melder_calloc_f (struct structStackel, 10000);
-	if (! theStack)
-		Melder_throw (U"Out of memory during formula computation.");
 	w = 0, wmax = 0;   // start new stack
 	try {
-		while (programPointer <= numberOfInstructions) {
+		while (programPointer <= theProgramLength) {
 			int symbol;
 				switch (symbol = f [programPointer]. symbol) {
 
@@ -6500,10 +6591,66 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 } break; case LT_: { do_lt ();
 } break; case GE_: { do_ge ();
 } break; case GT_: { do_gt ();
-} break; case ADD_: { do_add ();
-} break; case SUB_: { do_sub ();
-} break; case MUL_: { do_mul ();
+} break; case ADD_: {
+	Stackel y = & theStack [w], x = & theStack [w - 1];
+	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
+		x->number += y->number;   // what do_add () does, without the call
+		w --;
+	} else {
+		do_add ();
+	}
+} break; case SUB_: {
+	Stackel y = & theStack [w], x = & theStack [w - 1];
+	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
+		x->number -= y->number;   // what do_sub () does, without the call
+		w --;
+	} else {
+		do_sub ();
+	}
+} break; case MUL_: {
+	Stackel y = & theStack [w], x = & theStack [w - 1];
+	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
+		double product = x->number * y->number;
+		x->number = isdefined (product) ? product : undefined;   // what do_mul () does via pushNumber ()
+		w --;
+	} else {
+		do_mul ();
+	}
 } break; case RDIV_: { do_rdiv ();
+} break; case ADD_NUMBER_: {
+	Stackel x = topOfStack;
+	if (x->which == Stackel_NUMBER) {
+		x->number += f [programPointer]. content.number;
+	} else {
+		pushNumber (f [programPointer]. content.number);
+		do_add ();
+	}
+} break; case SUB_NUMBER_: {
+	Stackel x = topOfStack;
+	if (x->which == Stackel_NUMBER) {
+		x->number -= f [programPointer]. content.number;
+	} else {
+		pushNumber (f [programPointer]. content.number);
+		do_sub ();
+	}
+} break; case MUL_NUMBER_: {
+	Stackel x = topOfStack;
+	if (x->which == Stackel_NUMBER) {
+		double product = x->number * f [programPointer]. content.number;
+		x->number = isdefined (product) ? product : undefined;
+	} else {
+		pushNumber (f [programPointer]. content.number);
+		do_mul ();
+	}
+} break; case RDIV_NUMBER_: {
+	Stackel x = topOfStack;
+	if (x->which == Stackel_NUMBER) {
+		double quotient = x->number / f [programPointer]. content.number;
+		x->number = isdefined (quotient) ? quotient : undefined;
+	} else {
+		pushNumber (f [programPointer]. content.number);
+		do_rdiv ();
+	}
 } break; case IDIV_: { do_idiv ();
 } break; case MOD_: { do_mod ();
 } break; case MINUS_: { do_minus ();
@@ -6840,18 +6987,18 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	InterpreterVariable var = f [programPointer]. content.variable;
 	autostring32 string = Melder_dup (var -> stringValue);
 	pushString (string.transfer());
-} break; default: Melder_throw (U"Symbol \"", Formula_instructionNames [parse [programPointer]. symbol], U"\" without action.");
+} break; default: Melder_throw (U"Symbol \"", Formula_instructionNames [f [programPointer]. symbol], U"\" without action.");
 			} // endswitch
 			programPointer ++;
 		} // endwhile
 		if (w != 1) Melder_fatal (U"Formula: stackpointer ends at ", w, U" instead of 1.");
-		if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC) {
+		if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC) {
 			if (theStack [1]. which == Stackel_STRING) Melder_throw (U"Found a string expression instead of a numeric expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR) Melder_throw (U"Found a vector expression instead of a numeric expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_MATRIX) Melder_throw (U"Found a matrix expression instead of a numeric expression.");
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 			result -> numericResult = theStack [1]. number;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_STRING) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression (value ", theStack [1]. number, U") instead of a string expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR) Melder_throw (U"Found a vector expression instead of a string expression.");
@@ -6859,7 +7006,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_STRING;
 			result -> stringResult = theStack [1]. string;   // dangle...
 			theStack [1]. string = nullptr;   // ...undangle (and disown)
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
 			if (theStack [1]. which == Stackel_NUMBER) Melder_throw (U"Found a numeric expression instead of a vector expression.");
 			if (theStack [1]. which == Stackel_STRING) Melder_throw (U"Found a string expression instead of a vector expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_MATRIX) Melder_throw (U"Found a matrix expression instead of a vector expression.");
@@ -6867,7 +7014,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> numericVectorResult = theStack [1]. numericVector;
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;   // optionally undangle
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
+		} else if (expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
 			if (theStack [1]. which == Stackel_NUMBER) Melder_throw (U"Found a numeric expression instead of a matrix expression.");
 			if (theStack [1]. which == Stackel_STRING) Melder_throw (U"Found a string expression instead of a matrix expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR) Melder_throw (U"Found a vector expression instead of a matrix expression.");
@@ -6876,7 +7023,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;   // optionally undangle
 		} else {
-			Melder_assert (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_UNKNOWN);
+			Melder_assert (expressionType == kFormula_EXPRESSION_TYPE_UNKNOWN);
 			if (theStack [1]. which == Stackel_NUMBER) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 				result -> numericResult = theStack [1]. number;
@@ -6921,4 +7068,314 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	}
 }
 
+/*
+	The state of the evaluator that a nested run has to put aside.
+*/
+struct FormulaRunState {
+	FormulaInstruction program;
+	int programLength, programPointer;
+	Interpreter interpreter;
+	Daata source;
+	bool optimize;
+	Stackel stack;
+	integer w, wmax;
+};
+
+static void FormulaRunState_save (FormulaRunState *me) {
+	my program = theProgram;
+	my programLength = theProgramLength;
+	my programPointer = programPointer;
+	my interpreter = theInterpreter;
+	my source = theSource;
+	my optimize = theOptimize;
+	my stack = theStack;
+	my w = w;
+	my wmax = wmax;
+}
+
+static void FormulaRunState_restore (FormulaRunState *me) {
+	theProgram = my program;
+	theProgramLength = my programLength;
+	programPointer = my programPointer;
+	theInterpreter = my interpreter;
+	theSource = my source;
+	theOptimize = my optimize;
+	theStack = my stack;
+	w = my w;
+	wmax = my wmax;
+}
+
+static void Formula_runProgram (FormulaInstruction program, int programLength, Interpreter interpreter, Daata source,
+	int expressionType, bool optimize, integer row, integer col, Formula_Result *result)
+{
+	if (theFormulaDepth >= MAXIMUM_FORMULA_DEPTH)
+		Melder_throw (U"Formulas nested more than ", MAXIMUM_FORMULA_DEPTH, U" deep.");
+	FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth + 1];
+	if (! depth -> stack) depth -> stack = Melder_calloc_f (struct structStackel, 10000);
+	if (! depth -> stack)
+		Melder_throw (U"Out of memory during formula computation.");
+	FormulaRunState savedState;
+	FormulaRunState_save (& savedState);
+	theFormulaDepth += 1;
+	theProgram = program;
+	theProgramLength = programLength;
+	theInterpreter = interpreter;
+	theSource = source;
+	theOptimize = optimize;
+	theStack = depth -> stack;
+	try {
+		Formula_run_ (row, col, expressionType, result);
+	} catch (MelderError) {
+		theFormulaDepth -= 1;
+		FormulaRunState_restore (& savedState);
+		throw;
+	}
+	theFormulaDepth -= 1;
+	FormulaRunState_restore (& savedState);
+}
+
+void Formula_run (integer row, integer col, Formula_Result *result) {
+	FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth];
+	Melder_assert (depth -> parse);
+	Formula_runProgram (depth -> parse, depth -> numberOfInstructions, depth -> interpreter, depth -> source,
+		depth -> expressionType, depth -> optimize, row, col, result);
+}
+
+Thing_implement (FormulaProgram, Thing, 0);
+
+static bool FormulaInstruction_ownsString (int symbol) {
+	return symbol == STRING_ || symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_ || symbol == CALL_;
+}
+
+void structFormulaProgram :: v_destroy () noexcept {
+	if (instructions) {
+		for (int i = 1; i <= numberOfInstructions; i ++)
+			if (FormulaInstruction_ownsString (instructions [i]. symbol))
+				Melder_free (instructions [i]. content.string);
+		Melder_free (instructions);
+	}
+	FormulaProgram_Parent :: v_destroy ();
+}
+
+autoFormulaProgram Formula_compileProgram (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize) {
+	try {
+		autoFormulaProgram me = Thing_new (FormulaProgram);
+		if (! interpreter) {
+			/*
+				The variables of the shared local interpreter are thrown away at every compilation,
+				so a program that has to last needs an interpreter of its own.
+			*/
+			my ownInterpreter = Interpreter_create (nullptr, nullptr);
+			interpreter = my ownInterpreter.get();
+		}
+		Formula_compile (interpreter, data, expression, expressionType, optimize);
+		FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth];
+		my instructions = Melder_calloc (struct structFormulaInstruction, depth -> numberOfInstructions + 1);
+		my numberOfInstructions = depth -> numberOfInstructions;
+		for (int i = 1; i <= my numberOfInstructions; i ++) {
+			my instructions [i] = depth -> parse [i];
+			if (FormulaInstruction_ownsString (my instructions [i]. symbol))
+				my instructions [i]. content.string = Melder_dup (depth -> parse [i]. content.string);   // the compiler's copy will be freed at the next compilation
+		}
+		my interpreter = interpreter;
+		my source = data;
+		my expressionType = expressionType;
+		my optimize = optimize;
+		return me;
+	} catch (MelderError) {
+		Melder_throw (U"Formula not compiled.");
+	}
+}
+
+void FormulaProgram_run (FormulaProgram me, integer row, integer col, Formula_Result *result) {
+	Formula_runProgram (my instructions, my numberOfInstructions, my interpreter, my source,
+		my expressionType, my optimize, row, col, result);
+}
+
+/*
+	Block evaluation.
+	A numeric formula that consists only of numbers, numeric variables, `self`, `row`, `col`, `x`, `y`,
+	arithmetic and deterministic numeric functions computes every cell independently of all the others.
+	Such a formula can be run on a whole block of columns at once, one instruction at a time,
+	so that every instruction becomes a simple loop over an array of values.
+	The values are computed exactly as Formula_run would compute them cell by cell.
+*/
+#define FORMULA_BLOCK_SIZE  256
+#define FORMULA_MAXIMUM_BLOCK_STACK  16
+
+static double (*FormulaInstruction_blockFunction (int symbol)) (double) {
+	switch (symbol) {
+		case SINC_: return NUMsinc;
+		case SINCPI_: return NUMsincpi;
+		case ARCSINH_: return NUMarcsinh;
+		case ARCCOSH_: return NUMarccosh;
+		case ARCTANH_: return NUMarctanh;
+		case SIGMOID_: return NUMsigmoid;
+		case INV_SIGMOID_: return NUMinvSigmoid;
+		case ERF_: return NUMerf;
+		case ERFC_: return NUMerfcc;
+		case GAUSS_P_: return NUMgaussP;
+		case GAUSS_Q_: return NUMgaussQ;
+		case INV_GAUSS_Q_: return NUMinvGaussQ;
+		case LN_GAMMA_: return NUMlnGamma;
+		case HERTZ_TO_BARK_: return NUMhertzToBark;
+		case BARK_TO_HERTZ_: return NUMbarkToHertz;
+		case HERTZ_TO_MEL_: return NUMhertzToMel;
+		case MEL_TO_HERTZ_: return NUMmelToHertz;
+		case HERTZ_TO_SEMITONES_: return NUMhertzToSemitones;
+		case SEMITONES_TO_HERTZ_: return NUMsemitonesToHertz;
+		case ERB_: return NUMerb;
+		case HERTZ_TO_ERB_: return NUMhertzToErb;
+		case ERB_TO_HERTZ_: return NUMerbToHertz;
+		default: return nullptr;
+	}
+}
+
+bool Formula_canRunBlocks () {
+	if (Melder_debug == 53) return false;   // evaluate cell by cell, for comparison
+	FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth];
+	Daata source = depth -> source;
+	if (! depth -> parse || depth -> expressionType != kFormula_EXPRESSION_TYPE_NUMERIC) return false;
+	int stackSize = 0;
+	for (int i = 1; i <= depth -> numberOfInstructions; i ++) {
+		switch (int symbol = depth -> parse [i]. symbol) {
+			case NUMBER_: case NUMERIC_VARIABLE_: case ROW_: case COL_: {
+				if (++ stackSize > FORMULA_MAXIMUM_BLOCK_STACK) return false;
+			} break; case X_: {
+				if (! source || ! source -> v_hasGetX ()) return false;
+				if (++ stackSize > FORMULA_MAXIMUM_BLOCK_STACK) return false;
+			} break; case Y_: {
+				if (! source || ! source -> v_hasGetY ()) return false;
+				if (++ stackSize > FORMULA_MAXIMUM_BLOCK_STACK) return false;
+			} break; case SELF0_: {
+				if (! source || ! (source -> v_hasGetCell () || source -> v_hasGetVector () || source -> v_hasGetMatrix ())) return false;
+				if (++ stackSize > FORMULA_MAXIMUM_BLOCK_STACK) return false;
+			} break; case ADD_: case SUB_: case MUL_: case RDIV_: case POWER_: {
+				if (stackSize < 2) return false;
+				stackSize --;
+			} break; case ADD_NUMBER_: case SUB_NUMBER_: case MUL_NUMBER_: case RDIV_NUMBER_:
+				case MINUS_: case SQR_: case ABS_: case ROUND_: case FLOOR_: case CEILING_: case SQRT_:
+				case SIN_: case COS_: case TAN_: case ARCSIN_: case ARCCOS_: case ARCTAN_:
+				case EXP_: case SINH_: case COSH_: case TANH_: case LOG2_: case LN_: case LOG10_:
+			{
+				if (stackSize < 1) return false;
+			} break; default: {
+				if (! FormulaInstruction_blockFunction (symbol) || stackSize < 1) return false;
+			}
+		}
+	}
+	return stackSize == 1;
+}
+
+inline static double definedOrUndefined (double x) {
+	return isdefined (x) ? x : undefined;   // what pushNumber () does
+}
+
+void Formula_runBlock (integer row, integer firstColumn, integer lastColumn, double *result) {
+	FormulaDepth *depth = & theFormulaThreadState. depths [theFormulaDepth];
+	FormulaInstruction f = depth -> parse;
+	Daata source = depth -> source;
+	Melder_assert (row >= 1 && firstColumn >= 1);
+	double stack [1 + FORMULA_MAXIMUM_BLOCK_STACK] [FORMULA_BLOCK_SIZE];
+	for (integer blockStart = firstColumn; blockStart <= lastColumn; blockStart += FORMULA_BLOCK_SIZE) {
+		integer n = lastColumn - blockStart + 1;
+		if (n > FORMULA_BLOCK_SIZE) n = FORMULA_BLOCK_SIZE;
+		int sp = 0;
+		for (int i = 1; i <= depth -> numberOfInstructions; i ++) {
+			int symbol = f [i]. symbol;
+			switch (symbol) {
+				case NUMBER_: case NUMERIC_VARIABLE_: case Y_: {
+					double value = definedOrUndefined (
+						symbol == NUMBER_ ? f [i]. content.number :
+						symbol == NUMERIC_VARIABLE_ ? f [i]. content.variable -> numericValue :
+						source -> v_getY (row));
+					double *y = stack [++ sp];
+					for (integer k = 0; k < n; k ++) y [k] = value;
+				} break; case ROW_: {
+					double *y = stack [++ sp];
+					for (integer k = 0; k < n; k ++) y [k] = row;
+				} break; case COL_: {
+					double *y = stack [++ sp];
+					for (integer k = 0; k < n; k ++) y [k] = blockStart + k;
+				} break; case X_: {
+					double *y = stack [++ sp];
+					for (integer k = 0; k < n; k ++) y [k] = definedOrUndefined (source -> v_getX (blockStart + k));
+				} break; case SELF0_: {
+					double *y = stack [++ sp];
+					if (source -> v_hasGetCell ()) {
+						double value = definedOrUndefined (source -> v_getCell ());
+						for (integer k = 0; k < n; k ++) y [k] = value;
+					} else if (source -> v_hasGetVector ()) {
+						for (integer k = 0; k < n; k ++) y [k] = definedOrUndefined (source -> v_getVector (row, blockStart + k));
+					} else {
+						for (integer k = 0; k < n; k ++) y [k] = definedOrUndefined (source -> v_getMatrix (row, blockStart + k));
+					}
+				} break; case ADD_: {
+					double *x = stack [sp - 1], *y = stack [sp --];
+					for (integer k = 0; k < n; k ++) x [k] += y [k];
+				} break; case SUB_: {
+					double *x = stack [sp - 1], *y = stack [sp --];
+					for (integer k = 0; k < n; k ++) x [k] -= y [k];
+				} break; case MUL_: {
+					double *x = stack [sp - 1], *y = stack [sp --];
+					for (integer k = 0; k < n; k ++) x [k] = definedOrUndefined (x [k] * y [k]);
+				} break; case RDIV_: {
+					double *x = stack [sp - 1], *y = stack [sp --];
+					for (integer k = 0; k < n; k ++) x [k] = definedOrUndefined (x [k] / y [k]);
+				} break; case ADD_NUMBER_: {
+					double *x = stack [sp], number = f [i]. content.number;
+					for (integer k = 0; k < n; k ++) x [k] += number;
+				} break; case SUB_NUMBER_: {
+					double *x = stack [sp], number = f [i]. content.number;
+					for (integer k = 0; k < n; k ++) x [k] -= number;
+				} break; case MUL_NUMBER_: {
+					double *x = stack [sp], number = f [i]. content.number;
+					for (integer k = 0; k < n; k ++) x [k] = definedOrUndefined (x [k] * number);
+				} break; case RDIV_NUMBER_: {
+					double *x = stack [sp], number = f [i]. content.number;
+					for (integer k = 0; k < n; k ++) x [k] = definedOrUndefined (x [k] / number);
+				} break; case POWER_: {
+					double *x = stack [sp - 1], *y = stack [sp --];
+					for (integer k = 0; k < n; k ++)
+						x [k] = definedOrUndefined (isundef (x [k]) || isundef (y [k]) ? undefined : pow (x [k], y [k]));
+				} break; case MINUS_: {
+					double *x = stack [sp];
+					for (integer k = 0; k < n; k ++) x [k] = definedOrUndefined (- x [k]);
+				} break; default: {
+					double *x = stack [sp];
+					double (*function) (double) = FormulaInstruction_blockFunction (symbol);
+					for (integer k = 0; k < n; k ++) {
+						double value = x [k];
+						x [k] = definedOrUndefined ( isundef (value) ? undefined :
+							function ? function (value) :
+							symbol == SQR_ ? value * value :
+							symbol == ABS_ ? fabs (value) :
+							symbol == ROUND_ ? floor (value + 0.5) :
+							symbol == FLOOR_ ? Melder_roundDown (value) :
+							symbol == CEILING_ ? Melder_roundUp (value) :
+							symbol == SQRT_ ? ( value < 0.0 ? undefined : sqrt (value) ) :
+							symbol == SIN_ ? sin (value) :
+							symbol == COS_ ? cos (value) :
+							symbol == TAN_ ? tan (value) :
+							symbol == ARCSIN_ ? ( fabs (value) > 1.0 ? undefined : asin (value) ) :
+							symbol == ARCCOS_ ? ( fabs (value) > 1.0 ? undefined : acos (value) ) :
+							symbol == ARCTAN_ ? atan (value) :
+							symbol == EXP_ ? exp (value) :
+							symbol == SINH_ ? sinh (value) :
+							symbol == COSH_ ? cosh (value) :
+							symbol == TANH_ ? tanh (value) :
+							symbol == LOG2_ ? ( value <= 0.0 ? undefined : log (value) * NUMlog2e ) :
+							symbol == LN_ ? ( value <= 0.0 ? undefined : log (value) ) :
+							symbol == LOG10_ ? ( value <= 0.0 ? undefined : log10 (value) ) :
+							undefined
+						);
+					}
+				}
+			}
+		}
+		Melder_assert (sp == 1);
+		for (integer k = 0; k < n; k ++) result [blockStart + k] = stack [1] [k];
+	}
+}
+
 /* End of file Formula.cpp */
@@ -71,6 +71,46 @@ Thing_declare (Interpreter);
 void Formula_compile (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize);
 
 void Formula_run (integer row, integer col, Formula_Result *result);
+/*
+	Runs the formula that was last compiled with Formula_compile (in the same thread and at the same nesting depth).
+*/
+
+Thing_define (FormulaProgram, Thing) {
+	struct structFormulaInstruction *instructions;
+	int numberOfInstructions;
+	Interpreter interpreter;
+	autoInterpreter ownInterpreter;   // only if the program was compiled without an interpreter
+	Daata source;
+	int expressionType;
+	bool optimize;
+
+	void v_destroy () noexcept
+		override;
+};
+
+autoFormulaProgram Formula_compileProgram (Interpreter interpreter, Daata data, const char32 *expression, int expressionType, bool optimize);
+/*
+	Compiles the expression into a program of its own, which is not affected by later compilations,
+	so that it can be run again after other formulas have been compiled and run, also from within them.
+	The state of the compiler and of the evaluation stack is per thread, but that does not make the program
+	safe to run concurrently: errors (Melder_throw), the random-number functions,
+	and the lookup of variables in `interpreter` all use global state.
+	The program refers to the variables of `interpreter` and to `data`, so these have to outlive it.
+*/
+
+void FormulaProgram_run (FormulaProgram me, integer row, integer col, Formula_Result *result);
+
+bool Formula_canRunBlocks ();
+/*
+	Whether the numeric formula that was last compiled with Formula_compile
+	computes every cell from its own `self`, `row`, `col`, `x` and `y` only,
+	so that Formula_runBlock can be used instead of Formula_run.
+*/
+void Formula_runBlock (integer row, integer firstColumn, integer lastColumn, double *result);
+/*
+	Runs the formula for the cells [row] [firstColumn..lastColumn],
+	and puts the values into result [firstColumn..lastColumn].
+*/
 
 /* End of file Formula.h */
 #endif
@@ -1362,6 +1362,7 @@ static void assignToNumericMatrixElement (Interpreter me, char32 *& p, const cha
 
 void Interpreter_run (Interpreter me, char32 *text) {
 	autoNUMvector <char32 *> lines;   // not autostringvector, because the elements are reference copies
+	autoNUMvector <integer> jumpLines, alternativeJumpLines;   // the matching lines of control statements, found once and remembered
 	integer lineNumber = 0;
 	bool assertionFailed = false;
 	try {
@@ -1401,6 +1402,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 		 * Remember line starts and labels.
 		 */
 		lines.reset (1, numberOfLines);
+		jumpLines.reset (1, numberOfLines);   // 0 means: not yet looked up
+		alternativeJumpLines.reset (1, numberOfLines);
 		for (lineNumber = 1, command = text; lineNumber <= numberOfLines; lineNumber ++, command += str32len (command) + 1 + chopped) {
 			while (Melder_isHorizontalSpace (*command) || *command == UNICODE_NO_BREAK_SPACE) command ++;   // nbsp can occur for scripts copied from the manual
 			/*
@@ -1608,82 +1611,108 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							if (str32nequ (command2.string, U"endif", 5) && ! Melder_staysWithinInk (command2.string [5])) {
 								/* Ignore. */
 							} else if (str32nequ (command2.string, U"endfor", 6) && ! Melder_staysWithinInk (command2.string [6])) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber - 1; iline > 0; iline --) {
-									char32 *line = lines [iline];
-									if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
-										if (depth == 0) { lineNumber = iline - 1; fromendfor = true; break; }   // go before 'for'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"endfor", 6) && ! Melder_staysWithinInk (lines [iline] [6])) {
-										depth ++;
+								integer forLine = jumpLines [lineNumber];
+								if (forLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber - 1; iline > 0; iline --) {
+										char32 *line = lines [iline];
+										if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
+											if (depth == 0) { forLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"endfor", 6) && ! Melder_staysWithinInk (lines [iline] [6])) {
+											depth ++;
+										}
 									}
+									if (forLine == 0) Melder_throw (U"Unmatched 'endfor'.");
+									jumpLines [lineNumber] = forLine;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endfor'.");
+								lineNumber = forLine - 1;   // go before 'for'
+								fromendfor = true;
 							} else if (str32nequ (command2.string, U"endwhile", 8) && ! Melder_staysWithinInk (command2.string [8])) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber - 1; iline > 0; iline --) {
-									if (str32nequ (lines [iline], U"while ", 6)) {
-										if (depth == 0) { lineNumber = iline - 1; break; }   // go before 'while'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"endwhile", 8) && ! Melder_staysWithinInk (lines [iline] [8])) {
-										depth ++;
+								integer whileLine = jumpLines [lineNumber];
+								if (whileLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber - 1; iline > 0; iline --) {
+										if (str32nequ (lines [iline], U"while ", 6)) {
+											if (depth == 0) { whileLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"endwhile", 8) && ! Melder_staysWithinInk (lines [iline] [8])) {
+											depth ++;
+										}
 									}
+									if (whileLine == 0) Melder_throw (U"Unmatched 'endwhile'.");
+									jumpLines [lineNumber] = whileLine;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endwhile'.");
+								lineNumber = whileLine - 1;   // go before 'while'
 							} else if (str32nequ (command2.string, U"endproc", 7) && ! Melder_staysWithinInk (command2.string [7])) {
 								if (callDepth == 0) Melder_throw (U"Unmatched 'endproc'.");
 								lineNumber = callStack [callDepth --];
 								-- my callDepth;
 							} else fail = true;
 						} else if (str32nequ (command2.string, U"else", 4) && ! Melder_staysWithinInk (command2.string [4])) {
-							int depth = 0;
-							integer iline;
-							for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-								if (str32nequ (lines [iline], U"endif", 5) && ! Melder_staysWithinInk (lines [iline] [5])) {
-									if (depth == 0) { lineNumber = iline; break; }   // go after `endif`
-									else depth --;
-								} else if (str32nequ (lines [iline], U"if ", 3)) {
-									depth ++;
+							integer endifLine = jumpLines [lineNumber];
+							if (endifLine == 0) {
+								int depth = 0;
+								for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+									if (str32nequ (lines [iline], U"endif", 5) && ! Melder_staysWithinInk (lines [iline] [5])) {
+										if (depth == 0) { endifLine = iline; break; }
+										else depth --;
+									} else if (str32nequ (lines [iline], U"if ", 3)) {
+										depth ++;
+									}
 								}
+								if (endifLine == 0) Melder_throw (U"Unmatched 'else'.");
+								jumpLines [lineNumber] = endifLine;
 							}
-							if (iline > numberOfLines) Melder_throw (U"Unmatched 'else'.");
+							lineNumber = endifLine;   // go after `endif`
 						} else if (str32nequ (command2.string, U"elsif ", 6) || str32nequ (command2.string, U"elif ", 5)) {
 							if (fromif) {
 								double value;
 								fromif = false;
 								Interpreter_numericExpression (me, command2.string + 5, & value);
 								if (value == 0.0) {
+									integer nextLine = jumpLines [lineNumber];
+									if (nextLine == 0) {
+										int depth = 0;
+										for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+											if (str32nequ (lines [iline], U"endif", 5) && ! Melder_staysWithinInk (lines [iline] [5])) {
+												if (depth == 0) { nextLine = iline; break; }
+												else depth --;
+											} else if (str32nequ (lines [iline], U"else", 4) && ! Melder_staysWithinInk (lines [iline] [4])) {
+												if (depth == 0) { nextLine = iline; break; }
+											} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
+												|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
+												if (depth == 0) { nextLine = iline; break; }
+											} else if (str32nequ (lines [iline], U"if ", 3)) {
+												depth ++;
+											}
+										}
+										if (nextLine == 0) Melder_throw (U"Unmatched 'elsif'.");
+										jumpLines [lineNumber] = nextLine;
+									}
+									if (str32nequ (lines [nextLine], U"elsif", 5) || str32nequ (lines [nextLine], U"elif", 4)) {
+										lineNumber = nextLine - 1;   // go at next 'elsif' or 'elif'
+										fromif = true;
+									} else {
+										lineNumber = nextLine;   // go after `endif` or `else`
+									}
+								}
+							} else {
+								integer endifLine = alternativeJumpLines [lineNumber];
+								if (endifLine == 0) {
 									int depth = 0;
-									integer iline;
-									for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+									for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
 										if (str32nequ (lines [iline], U"endif", 5) && ! Melder_staysWithinInk (lines [iline] [5])) {
-											if (depth == 0) { lineNumber = iline; break; }   // go after `endif`
+											if (depth == 0) { endifLine = iline; break; }
 											else depth --;
-										} else if (str32nequ (lines [iline], U"else", 4) && ! Melder_staysWithinInk (lines [iline] [4])) {
-											if (depth == 0) { lineNumber = iline; break; }   // go after `else`
-										} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
-											|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
-											if (depth == 0) { lineNumber = iline - 1; fromif = true; break; }   // go at next 'elsif' or 'elif'
 										} else if (str32nequ (lines [iline], U"if ", 3)) {
 											depth ++;
 										}
 									}
-									if (iline > numberOfLines) Melder_throw (U"Unmatched 'elsif'.");
-								}
-							} else {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5) && ! Melder_staysWithinInk (lines [iline] [5])) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after `endif`
-										else depth --;
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
-									}
+									if (endifLine == 0) Melder_throw (U"'elsif' not matched with 'endif'.");
+									alternativeJumpLines [lineNumber] = endifLine;
 								}
-								if (iline > numberOfLines) Melder_throw (U"'elsif' not matched with 'endif'.");
+								lineNumber = endifLine;   // go after `endif`
 							}
 						} else if (str32nequ (command2.string, U"exit", 4)) {
 							if (command2.string [4] == U'\0') {
@@ -1721,17 +1750,21 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							}
 							var -> numericValue = loopVariable;
 							if (loopVariable > toValue) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endfor", 6)) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after 'endfor'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"for ", 4)) {
-										depth ++;
+								integer endforLine = jumpLines [lineNumber];
+								if (endforLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endfor", 6)) {
+											if (depth == 0) { endforLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"for ", 4)) {
+											depth ++;
+										}
 									}
+									if (endforLine == 0) Melder_throw (U"Unmatched 'for'.");
+									jumpLines [lineNumber] = endforLine;
 								}
-								if (iline > numberOfLines) Melder_throw (U"Unmatched 'for'.");
+								lineNumber = endforLine;   // go after 'endfor'
 							}
 						} else if (str32nequ (command2.string, U"form", 4) && Melder_isEndOfInk (command2.string [4])) {
 							integer iline;
@@ -1769,21 +1802,30 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 3, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5)) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after 'endif'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"else", 4)) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after 'else'
-									} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
-										if (depth == 0) { lineNumber = iline - 1; fromif = true; break; }   // go at 'elsif'
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
+								integer nextLine = jumpLines [lineNumber];
+								if (nextLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endif", 5)) {
+											if (depth == 0) { nextLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"else", 4)) {
+											if (depth == 0) { nextLine = iline; break; }
+										} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
+											if (depth == 0) { nextLine = iline; break; }
+										} else if (str32nequ (lines [iline], U"if ", 3)) {
+											depth ++;
+										}
 									}
+									if (nextLine == 0) Melder_throw (U"Unmatched 'if'.");
+									jumpLines [lineNumber] = nextLine;
+								}
+								if (str32nequ (lines [nextLine], U"elsif ", 6) || str32nequ (lines [nextLine], U"elif ", 5)) {
+									lineNumber = nextLine - 1;   // go at 'elsif'
+									fromif = true;
+								} else {
+									lineNumber = nextLine;   // go after 'endif' or 'else'
 								}
-								if (iline > numberOfLines) Melder_throw (U"Unmatched 'if'.");
 							} else if (isundef (value)) {
 								Melder_throw (U"The value of the 'if' condition is undefined.");
 							}
@@ -1852,17 +1894,21 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 6, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline = lineNumber - 1;
-								for (; iline > 0; iline --) {
-									if (str32nequ (lines [iline], U"repeat", 6) && ! Melder_staysWithinInk (lines [iline] [6])) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after `repeat`
-										else depth --;
-									} else if (str32nequ (lines [iline], U"until ", 6)) {
-										depth ++;
+								integer repeatLine = jumpLines [lineNumber];
+								if (repeatLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber - 1; iline > 0; iline --) {
+										if (str32nequ (lines [iline], U"repeat", 6) && ! Melder_staysWithinInk (lines [iline] [6])) {
+											if (depth == 0) { repeatLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"until ", 6)) {
+											depth ++;
+										}
 									}
+									if (repeatLine == 0) Melder_throw (U"Unmatched 'until'.");
+									jumpLines [lineNumber] = repeatLine;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'until'.");
+								lineNumber = repeatLine;   // go after `repeat`
 							}
 						} else fail = true;
 						break;
@@ -1874,17 +1920,21 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 6, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline = lineNumber + 1;
-								for (; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endwhile", 8) && ! Melder_staysWithinInk (lines [iline] [8])) {
-										if (depth == 0) { lineNumber = iline; break; }   // go after `endwhile`
-										else depth --;
-									} else if (str32nequ (lines [iline], U"while ", 6)) {
-										depth ++;
+								integer endwhileLine = jumpLines [lineNumber];
+								if (endwhileLine == 0) {
+									int depth = 0;
+									for (integer iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endwhile", 8) && ! Melder_staysWithinInk (lines [iline] [8])) {
+											if (depth == 0) { endwhileLine = iline; break; }
+											else depth --;
+										} else if (str32nequ (lines [iline], U"while ", 6)) {
+											depth ++;
+										}
 									}
+									if (endwhileLine == 0) Melder_throw (U"Unmatched 'while'.");
+									jumpLines [lineNumber] = endwhileLine;
 								}
-								if (iline > numberOfLines) Melder_throw (U"Unmatched 'while'.");
+								lineNumber = endwhileLine;   // go after `endwhile`
 							}
 						} else fail = true;
 						break;
@@ -80,6 +80,7 @@
 #endif
 
 inline static int MelderThread_getNumberOfProcessors () {
+	if (Melder_debug == 52) return 1;   // run everything in the main thread, for comparison
 	#if USE_WINTHREADS
 		return 8;
 	#elif USE_PTHREADS
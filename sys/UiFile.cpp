@@ -44,25 +44,40 @@ UiForm UiInfile_create (GuiWindow parent, const char32 *title,
 	return me.releaseToAmbiguousOwner();
 }
 
+struct UiInfile_Closure {
+	UiForm form;
+	StringSet infileNames;
+};
+
+static const char32 * UiInfile_getInfileName (void *void_closure, integer ifile) {
+	UiInfile_Closure *closure = static_cast <UiInfile_Closure *> (void_closure);
+	return closure -> infileNames -> at [ifile] -> string;
+}
+
+static void UiInfile_readFile (void *void_closure, integer ifile) {
+	UiInfile_Closure *closure = static_cast <UiInfile_Closure *> (void_closure);
+	UiForm me = closure -> form;
+	SimpleString infileName = closure -> infileNames -> at [ifile];
+	Melder_pathToFile (infileName -> string, & my file);
+	UiHistory_write (U"\n");
+	UiHistory_write_colonize (my invokingButtonTitle);
+	UiHistory_write (U" \"");
+	UiHistory_write_expandQuotes (infileName -> string);
+	UiHistory_write (U"\"");
+	structMelderFile file { };
+	MelderFile_copy (& my file, & file);
+	try {
+		my okCallback (me, 0, nullptr, nullptr, nullptr, my invokingButtonTitle, false, my buttonClosure);
+	} catch (MelderError) {
+		Melder_throw (U"File ", & file, U" not finished.");
+	}
+}
+
 void UiInfile_do (UiForm me) {
 	try {
 		autoStringSet infileNames = GuiFileSelect_getInfileNames (my d_dialogParent, my name, my allowMultipleFiles);
-		for (integer ifile = 1; ifile <= infileNames->size; ifile ++) {
-			SimpleString infileName = infileNames->at [ifile];
-			Melder_pathToFile (infileName -> string, & my file);
-			UiHistory_write (U"\n");
-			UiHistory_write_colonize (my invokingButtonTitle);
-			UiHistory_write (U" \"");
-			UiHistory_write_expandQuotes (infileName -> string);
-			UiHistory_write (U"\"");
-			structMelderFile file { };
-			MelderFile_copy (& my file, & file);
-			try {
-				my okCallback (me, 0, nullptr, nullptr, nullptr, my invokingButtonTitle, false, my buttonClosure);
-			} catch (MelderError) {
-				Melder_throw (U"File ", & file, U" not finished.");
-			}
-		}
+		UiInfile_Closure closure { me, infileNames.get() };
+		Melder_readFilesWithPrefetching (infileNames->size, UiInfile_getInfileName, UiInfile_readFile, & closure);
 	} catch (MelderError) {
 		Melder_flushError ();
 	}
@@ -41,17 +41,73 @@
 
 /********** text I/O **********/
 
+/*
+	Text-format files consist almost entirely of ASCII characters,
+	which in 8-bit text look the same in all supported encodings (UTF-8, MacRoman, Windows Latin-1).
+	We therefore read those straight from the buffer, and leave all other characters to MelderReadText_getChar.
+*/
+inline static char32 getChar (MelderReadText me) {
+	if (! my string32) {
+		const char8 kar = (char8) * my readPointer8;
+		if (kar < 128) {
+			if (kar != '\0') my readPointer8 ++;
+			return (char32) kar;
+		}
+	} else {
+		const char32 kar = * my readPointer32;
+		if (kar != U'\0') my readPointer32 ++;
+		return kar;
+	}
+	return MelderReadText_getChar (me);
+}
+
+/*
+	For a string of the form [+-]digits[.digits] with at most 15 significant digits in total,
+	the mantissa and the power of ten are both exactly representable as doubles,
+	so that a single multiplication or division gives the correctly rounded result, identical to what strtod () gives.
+	All other strings (exponents, fractions, percentages, long mantissas) go through Melder_a8tof.
+*/
+static double stringToReal (const char *string) {
+	static const double powersOfTen [] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+	const char *p = string;
+	const bool negative = ( *p == '-' );
+	if (*p == '-' || *p == '+') p ++;
+	if (*p < '0' || *p > '9')
+		return Melder_a8tof (string);
+	int64 mantissa = 0;
+	int numberOfDigits = 0, numberOfDecimals = 0;
+	for (; *p >= '0' && *p <= '9'; p ++) {
+		if (mantissa != 0 || *p != '0') numberOfDigits ++;   // leading zeroes are not significant
+		mantissa = 10 * mantissa + (*p - '0');
+		if (numberOfDigits > 15)
+			return Melder_a8tof (string);
+	}
+	if (*p == '.') {
+		for (p ++; *p >= '0' && *p <= '9'; p ++) {
+			if (mantissa != 0 || *p != '0') numberOfDigits ++;
+			mantissa = 10 * mantissa + (*p - '0');
+			numberOfDecimals ++;
+			if (numberOfDigits > 15 || numberOfDecimals > 15)
+				return Melder_a8tof (string);
+		}
+	}
+	if (*p != '\0')
+		return Melder_a8tof (string);
+	const double value = (double) mantissa / powersOfTen [numberOfDecimals];
+	return negative ? - value : value;
+}
+
 static int64 getInteger (MelderReadText me) {
 	char buffer [41];
 	char32 c;
 	/*
 	 * Look for the first numeric character.
 	 */
-	for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+			while ((c = getChar (me)) != U'\n' && c != U'\r') {
 				if (c == 0)
 					Melder_throw (U"Early end of text detected in comment while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
 			}
@@ -63,7 +119,7 @@ static int64 getInteger (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	int i = 0;
@@ -71,7 +127,7 @@ static int64 getInteger (MelderReadText me) {
 		if (c > 127)
 			Melder_throw (U"Found strange text while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
 		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = getChar (me);
 		if (c == U'\0') { break; }   // this may well be OK here
 		if (Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) break;
 	}
@@ -84,11 +140,11 @@ static int64 getInteger (MelderReadText me) {
 static uint64 getUnsigned (MelderReadText me) {
 	char buffer [41];
 	char32 c;
-	for (c = MelderReadText_getChar (me); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
+			while ((c = getChar (me)) != '\n' && c != '\r') {
 				if (c == U'\0')
 					Melder_throw (U"Early end of text detected in comment while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
 			}
@@ -102,7 +158,7 @@ static uint64 getUnsigned (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	int i = 0;
@@ -110,7 +166,7 @@ static uint64 getUnsigned (MelderReadText me) {
 		if (c > 127)
 			Melder_throw (U"Found strange text while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
 		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = getChar (me);
 		if (c == U'\0') { break; }   // this may well be OK here
 		if (Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) break;
 	}
@@ -125,11 +181,11 @@ static double getReal (MelderReadText me) {
 	char buffer [41], *slash;
 	char32 c;
 	do {
-		for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+		for (c = getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
 			if (c == U'!') {   // end-of-line comment?
-				while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+				while ((c = getChar (me)) != U'\n' && c != U'\r') {
 					if (c == U'\0')
 						Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
 				}
@@ -141,14 +197,14 @@ static double getReal (MelderReadText me) {
 			while (! Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) {
 				if (c == U'\0')
 					Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
-				c = MelderReadText_getChar (me);
+				c = getChar (me);
 			}
 		}
 		for (i = 0; i < 40; i ++) {
 			if (c > 127)
 				Melder_throw (U"Found strange text while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
 			buffer [i] = (char) (char8) c;   // guarded conversion down
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 			if (c == U'\0') { break; }   // this may well be OK here
 			if (Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) break;
 		}
@@ -160,21 +216,21 @@ static double getReal (MelderReadText me) {
 	if (slash) {
 		double numerator, denominator;
 		*slash = '\0';
-		numerator = Melder_a8tof (buffer), denominator = Melder_a8tof (slash + 1);
+		numerator = stringToReal (buffer), denominator = stringToReal (slash + 1);
 		if (isundef (numerator) || isundef (denominator) || denominator == 0.0)
 			return undefined;
 		return numerator / denominator;
 	}
-	return Melder_a8tof (buffer);
+	return stringToReal (buffer);
 }
 
 static int getEnum (MelderReadText me, int (*getValue) (const char32 *)) {
 	char32 buffer [41], c;
-	for (c = MelderReadText_getChar (me); c != U'<'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); c != U'<'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   /* End-of-line comment? */
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+			while ((c = getChar (me)) != U'\n' && c != U'\r') {
 				if (c == U'\0')
 					Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 			}
@@ -186,12 +242,12 @@ static int getEnum (MelderReadText me, int (*getValue) (const char32 *)) {
 		while (! Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	int i = 0;
 	for (; i < 40; i ++) {
-		c = MelderReadText_getChar (me);   // read past first '<'
+		c = getChar (me);   // read past first '<'
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while reading an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_))
@@ -212,11 +268,11 @@ static int getEnum (MelderReadText me, int (*getValue) (const char32 *)) {
 static char32 * getString (MelderReadText me) {
 	static MelderString buffer { };
 	MelderString_empty (& buffer);
-	for (char32 c = MelderReadText_getChar (me); c != U'\"'; c = MelderReadText_getChar (me)) {
+	for (char32 c = getChar (me); c != U'\"'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
+			while ((c = getChar (me)) != '\n' && c != '\r') {
 				if (c == U'\0')
 					Melder_throw (U"Early end of text detected in comment while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
 			}
@@ -228,15 +284,15 @@ static char32 * getString (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c, kMelder_charset::UNICODE_)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	for (int i = 0; 1; i ++) {
-		char32 c = MelderReadText_getChar (me);   // read past first '"'
+		char32 c = getChar (me);   // read past first '"'
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while reading a string (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'\"') {
-			char32 next = MelderReadText_getChar (me);
+			char32 next = getChar (me);
 			if (next == U'\0') { break; }   // closing quote is last character in file: OK
 			if (next != U'\"') {
 				if (Melder_isHorizontalOrVerticalSpace (next, kMelder_charset::UNICODE_)) {
@@ -358,12 +414,22 @@ void texindent (MelderFile file) { file -> indent += 4; }
 void texexdent (MelderFile file) { file -> indent -= 4; }
 void texresetindent (MelderFile file) { file -> indent = 0; }
 
+/*
+	The indentation is written in pieces of up to 64 spaces, rather than space by space.
+*/
+static void putIndent (MelderFile file) {
+	static const char32 spaces [] = U"                                                                ";   // 64 spaces
+	const int maximumPieceLength = 64;
+	for (int numberOfSpacesLeft = file -> indent; numberOfSpacesLeft > 0; numberOfSpacesLeft -= maximumPieceLength) {
+		const int pieceLength = numberOfSpacesLeft < maximumPieceLength ? numberOfSpacesLeft : maximumPieceLength;
+		MelderFile_write (file, & spaces [maximumPieceLength - pieceLength]);
+	}
+}
+
 void texputintro (MelderFile file, const char32 *s1, const char32 *s2, const char32 *s3, const char32 *s4, const char32 *s5, const char32 *s6) {
 	if (file -> verbose) {
 		MelderFile_write (file, U"\n");
-		for (int iindent = 1; iindent <= file -> indent; iindent ++) {
-			MelderFile_write (file, U" ");
-		}
+		putIndent (file);
 		MelderFile_write (file,
 			s1 && s1 [0] == U'd' && s1 [1] == U'_' ? & s1 [2] : & s1 [0],
 			s2 && s2 [0] == U'd' && s2 [1] == U'_' ? & s2 [2] : & s2 [0],
@@ -378,9 +444,7 @@ void texputintro (MelderFile file, const char32 *s1, const char32 *s2, const cha
 #define PUTLEADER  \
 	MelderFile_write (file, U"\n"); \
 	if (file -> verbose) { \
-		for (int iindent = 1; iindent <= file -> indent; iindent ++) { \
-			MelderFile_write (file, U" "); \
-		} \
+		putIndent (file); \
 		MelderFile_write (file, \
 			s1 && s1 [0] == U'd' && s1 [1] == U'_' ? & s1 [2] : & s1 [0], \
 			s2 && s2 [0] == U'd' && s2 [1] == U'_' ? & s2 [2] : & s2 [0], \
@@ -571,6 +635,18 @@ void texputw32 (MelderFile file, const char32 *s, const char32 *s1, const char32
 	#define binario_doubleIEEE8lsb 0
 #endif
 
+/*
+	On which machines can an array of IEEE numbers, Most Significant Bit first, be read or written in one go
+	and then be brought into native order by reversing the bytes of each number?
+	This is about the array routines only; the single-number routines above keep their own definitions.
+*/
+
+#if defined (__BYTE_ORDER__) && defined (__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	#define binario_arrayIEEElsb (sizeof (float) == 4 && sizeof (double) == 8)
+#else
+	#define binario_arrayIEEElsb (binario_floatIEEE4lsb && binario_doubleIEEE8lsb)
+#endif
+
 /*
 	The routines bingetr32, bingetr64, binputr32, and binputr64,
 	were implemented by Paul Boersma from the descriptions of the IEEE floating-point formats,
@@ -1077,6 +1153,95 @@ double bingetr64 (FILE *f) {
 	}
 }
 
+inline static uint32 reversedBytes32 (uint32 x) {
+	return x << 24 | (x & 0x0000FF00) << 8 | (x & 0x00FF0000) >> 8 | x >> 24;
+}
+
+inline static uint64 reversedBytes64 (uint64 x) {
+	return (uint64) reversedBytes32 ((uint32) x) << 32 | (uint64) reversedBytes32 ((uint32) (x >> 32));
+}
+
+#define binario_ARRAY_CHUNK  4096
+
+void bingetr32array (double *x, integer n, FILE *f) {
+	try {
+		if (n <= 0) return;
+		if ((binario_floatIEEE4msb || binario_arrayIEEElsb) && Melder_debug != 18) {
+			uint32 chunk [binario_ARRAY_CHUNK];
+			for (integer offset = 0; offset < n; offset += binario_ARRAY_CHUNK) {
+				integer chunkSize = n - offset < binario_ARRAY_CHUNK ? n - offset : binario_ARRAY_CHUNK;
+				if (fread (chunk, sizeof (uint32), (size_t) chunkSize, f) != (size_t) chunkSize)
+					readError (f, U"an array of 32-bit floating-point numbers.");
+				for (integer i = 0; i < chunkSize; i ++) {
+					union { uint32 bits; float value; } element;
+					element.bits = binario_floatIEEE4msb ? chunk [i] : reversedBytes32 (chunk [i]);
+					double value = element.value;
+					x [offset + i] = binario_floatIEEE4msb || isdefined (value) ? value : undefined;   // as bingetr32 does
+				}
+			}
+		} else {
+			for (integer i = 0; i < n; i ++)
+				x [i] = bingetr32 (f);
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 4 bytes each in binary file.");
+	}
+}
+
+void bingetr64array (double *x, integer n, FILE *f) {
+	try {
+		if (n <= 0) return;
+		if ((binario_doubleIEEE8msb && Melder_debug != 18) || Melder_debug == 181) {
+			if (fread (x, sizeof (double), (size_t) n, f) != (size_t) n)
+				readError (f, U"an array of 64-bit floating-point numbers.");
+		} else if (binario_arrayIEEElsb && Melder_debug != 18) {
+			if (fread (x, sizeof (double), (size_t) n, f) != (size_t) n)
+				readError (f, U"an array of 64-bit floating-point numbers.");
+			uint64 *bits = reinterpret_cast <uint64 *> (x);
+			for (integer i = 0; i < n; i ++)
+				bits [i] = reversedBytes64 (bits [i]);
+			for (integer i = 0; i < n; i ++)
+				if (isundef (x [i])) x [i] = undefined;   // as bingetr64 does
+		} else {
+			for (integer i = 0; i < n; i ++)
+				x [i] = bingetr64 (f);
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 8 bytes each in binary file.");
+	}
+}
+
+void binputr64array (const double *x, integer n, FILE *f) {
+	try {
+		if (n <= 0) return;
+		if ((binario_doubleIEEE8msb && Melder_debug != 18) || Melder_debug == 181) {
+			if (fwrite (x, sizeof (double), (size_t) n, f) != (size_t) n)
+				writeError (U"an array of 64-bit floating-point numbers.");
+		} else if (binario_arrayIEEElsb && Melder_debug != 18) {
+			uint64 chunk [binario_ARRAY_CHUNK];
+			const uint64 *bits = reinterpret_cast <const uint64 *> (x);
+			for (integer offset = 0; offset < n; offset += binario_ARRAY_CHUNK) {
+				integer chunkSize = n - offset < binario_ARRAY_CHUNK ? n - offset : binario_ARRAY_CHUNK;
+				for (integer i = 0; i < chunkSize; i ++) {
+					uint64 element = bits [offset + i];
+					if ((element & 0x7FF0000000000000) == 0x7FF0000000000000 && (element & 0x000FFFFFFFFFFFFF) != 0)
+						element = 0x7FF0000000000000;   // Not-a-Number becomes +Infinity, as in binputr64
+					else if (element == 0x8000000000000000)
+						element = 0;   // minus zero becomes plus zero, as in binputr64
+					chunk [i] = reversedBytes64 (element);
+				}
+				if (fwrite (chunk, sizeof (uint64), (size_t) chunkSize, f) != (size_t) chunkSize)
+					writeError (U"an array of 64-bit floating-point numbers.");
+			}
+		} else {
+			for (integer i = 0; i < n; i ++)
+				binputr64 (x [i], f);
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to 8 bytes each in binary file.");
+	}
+}
+
 double bingetr80 (FILE *f) {
 	try {
 		uint8 bytes [10];
@@ -168,6 +168,13 @@ double bingetr64 (FILE *f);   void binputr64 (double x, FILE *f);
 	This is the native format of a `double` on Silicon Graphics Iris and PowerMac.
 */
 
+void bingetr32array (double *x, integer n, FILE *f);
+void bingetr64array (double *x, integer n, FILE *f);   void binputr64array (const double *x, integer n, FILE *f);
+/*
+	Read or write the n numbers x [0] .. x [n - 1] in the same format as bingetr32, bingetr64 and binputr64,
+	with a single fread or fwrite per block of numbers (on IEEE machines) instead of one per number.
+*/
+
 double bingetr80 (FILE *f);   void binputr80 (double x, FILE *f);
 /*
 	Read or write a real number from or to 10 bytes in the stream `f`,
@@ -860,6 +860,16 @@ FILE * Melder_fopen (MelderFile file, const char *type);
 void Melder_fclose (MelderFile file, FILE *stream);
 void Melder_files_cleanUp ();
 
+/*
+	When many files are read one after another, the time is often dominated by the latency of opening and reading
+	each file (especially on network file systems), rather than by decoding the contents.
+	Melder_readFilesWithPrefetching calls `readFile (closure, ifile)` for every file, in order and in the calling thread,
+	while a background thread reads the next few files (to a limited number of bytes)
+	into the file cache of the operating system. If `readFile` throws, the background thread is stopped first.
+*/
+void Melder_readFilesWithPrefetching (integer numberOfFiles, const char32 * (*getPath) (void *closure, integer ifile),
+	void (*readFile) (void *closure, integer ifile), void *closure);
+
 /* Use the following functions to pass unchanged text or file names to Melder_* functions. */
 /* Backslashes are replaced by "\bs". */
 /* The trick is that they return one of 11 cyclically used static strings, */
@@ -1057,6 +1067,9 @@ void * NUMmatrix (integer elementSize, integer row1, integer row2, integer col1,
 	Preconditions:
 		row2 >= row1;
 		col2 >= col1;
+	Postconditions:
+		the cells form a single block, row after row, starting at & result [row1] [col1];
+		this first cell is aligned to 64 bytes, and the stride between rows is col2 - col1 + 1 elements.
 */
 
 void NUMmatrix_free_ (integer elementSize, byte **m, integer row1, integer col1) noexcept;
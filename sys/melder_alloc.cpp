@@ -19,9 +19,108 @@
 #include "melder.h"
 #include <wctype.h>
 #include <assert.h>
+#include <atomic>
+#include <mutex>
 
-static int64 totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0,
-	totalNumberOfMovingReallocs = 0, totalNumberOfReallocsInSitu = 0;
+/*
+	The allocation statistics.
+
+	Every thread keeps its own counts, so that allocating memory in several threads at the same time
+	involves neither locks nor contended memory. Each count is written only by its own thread
+	(as a relaxed atomic, so that reading it from another thread is not a data race),
+	and the counts are summed over all threads only when somebody asks for them (Melder_allocationCount and the like).
+	A thread registers itself in the list of live threads at its first allocation;
+	when the thread finishes, its counts are added to those of the finished threads.
+*/
+struct MelderAllocationCounts {
+	std::atomic <int64> numberOfAllocations, numberOfDeallocations, allocationSize,
+		numberOfMovingReallocs, numberOfReallocsInSitu;
+	MelderAllocationCounts *nextLiveThread;
+	bool registered;
+};
+
+static thread_local MelderAllocationCounts theCountsOfThisThread;   // trivially destructible, hence usable until the thread really ends
+static MelderAllocationCounts *theFirstLiveThread;
+static int64 theNumberOfAllocationsInFinishedThreads, theNumberOfDeallocationsInFinishedThreads, theAllocationSizeInFinishedThreads,
+	theNumberOfMovingReallocsInFinishedThreads, theNumberOfReallocsInSituInFinishedThreads;
+/*
+	Not a MelderThread_MUTEX: this mutex has to work from the very first allocation,
+	which can come from a static initializer in any other file, before anybody could call MelderThread_MUTEX_INIT
+	(needed on Windows, where MelderThread_MUTEX is a CRITICAL_SECTION); std::mutex is constant-initialized instead.
+	Also, MelderThread.h needs Thing.h, which lies above the allocator.
+*/
+static std::mutex theAllocationCountsMutex;
+
+static void addToCount (std::atomic <int64>& count, int64 amount) {
+	count.store (count.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);   // no read-modify-write needed, because only this thread writes
+}
+
+struct MelderAllocationCounts_finisher {
+	~MelderAllocationCounts_finisher () {
+		MelderAllocationCounts *me = & theCountsOfThisThread;
+		std::lock_guard <std::mutex> lock (theAllocationCountsMutex);
+		theNumberOfAllocationsInFinishedThreads += my numberOfAllocations.load (std::memory_order_relaxed);
+		theNumberOfDeallocationsInFinishedThreads += my numberOfDeallocations.load (std::memory_order_relaxed);
+		theAllocationSizeInFinishedThreads += my allocationSize.load (std::memory_order_relaxed);
+		theNumberOfMovingReallocsInFinishedThreads += my numberOfMovingReallocs.load (std::memory_order_relaxed);
+		theNumberOfReallocsInSituInFinishedThreads += my numberOfReallocsInSitu.load (std::memory_order_relaxed);
+		for (MelderAllocationCounts **link = & theFirstLiveThread; *link; link = & (*link) -> nextLiveThread) {
+			if (*link == me) {
+				*link = my nextLiveThread;
+				break;
+			}
+		}
+		/*
+			`registered` stays true, so that any later (de)allocations in this thread
+			(e.g. in the destructors of other thread-local objects) are no longer counted.
+		*/
+	}
+};
+static thread_local MelderAllocationCounts_finisher theFinisherOfThisThread;
+
+static MelderAllocationCounts *countsOfThisThread () {
+	MelderAllocationCounts *me = & theCountsOfThisThread;
+	if (! my registered) {
+		(void) & theFinisherOfThisThread;   // make sure that the finisher of this thread is constructed, and will therefore be destroyed
+		std::lock_guard <std::mutex> lock (theAllocationCountsMutex);
+		my nextLiveThread = theFirstLiveThread;
+		theFirstLiveThread = me;
+		my registered = true;
+	}
+	return me;
+}
+
+static void countAllocation (int64 size) {
+	MelderAllocationCounts *me = countsOfThisThread ();
+	addToCount (my numberOfAllocations, 1);
+	addToCount (my allocationSize, size);
+}
+
+static void countDeallocation () {
+	MelderAllocationCounts *me = countsOfThisThread ();
+	addToCount (my numberOfDeallocations, 1);
+}
+
+static void countMovingReallocation (int64 size) {
+	MelderAllocationCounts *me = countsOfThisThread ();
+	addToCount (my numberOfAllocations, 1);
+	addToCount (my allocationSize, size);
+	addToCount (my numberOfDeallocations, 1);
+	addToCount (my numberOfMovingReallocs, 1);
+}
+
+static void countReallocationInSitu () {
+	MelderAllocationCounts *me = countsOfThisThread ();
+	addToCount (my numberOfReallocsInSitu, 1);
+}
+
+static int64 sumOverThreads (int64 inFinishedThreads, std::atomic <int64> MelderAllocationCounts::* count) {
+	std::lock_guard <std::mutex> lock (theAllocationCountsMutex);
+	int64 sum = inFinishedThreads;
+	for (MelderAllocationCounts *thread = theFirstLiveThread; thread; thread = thread -> nextLiveThread)
+		sum += (thread ->* count).load (std::memory_order_relaxed);
+	return sum;
+}
 
 /*
  * The rainy-day fund.
@@ -64,8 +163,7 @@ void * _Melder_malloc (int64 size) {
 		Melder_throw (U"Out of memory: there is not enough room for another ", Melder_bigInteger (size), U" bytes.");
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_malloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t1");
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	countAllocation (size);
 	return result;
 }
 
@@ -84,8 +182,7 @@ void * _Melder_malloc_f (int64 size) {
 			Melder_fatal (U"Out of memory: there is not enough room for another ", Melder_bigInteger (size), U" bytes.");
 		}
 	}
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	countAllocation (size);
 	return result;
 }
 
@@ -95,7 +192,7 @@ void _Melder_free (void **ptr) noexcept {
 		Melder_casual (U"Melder_free\t", Melder_pointer (*ptr), U"\t?\t?");
 	free (*ptr);
 	*ptr = nullptr;
-	totalNumberOfDeallocations += 1;
+	countDeallocation ();
 }
 
 void * Melder_realloc (void *ptr, int64 size) {
@@ -109,15 +206,11 @@ void * Melder_realloc (void *ptr, int64 size) {
 	if (! ptr) {   // is it like malloc?
 		if (Melder_debug == 34)
 			Melder_casual (U"Melder_realloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t1");
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
+		countAllocation (size);
 	} else if (result != ptr) {   // did realloc do a malloc-and-free?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
-		totalNumberOfDeallocations += 1;
-		totalNumberOfMovingReallocs += 1;
+		countMovingReallocation (size);
 	} else {
-		totalNumberOfReallocsInSitu += 1;
+		countReallocationInSitu ();
 	}
 	return result;
 }
@@ -138,15 +231,11 @@ void * Melder_realloc_f (void *ptr, int64 size) {
 		}
 	}
 	if (! ptr) {   // is it like malloc?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
+		countAllocation (size);
 	} else if (result != ptr) {   // did realloc do a malloc-and-free?
-		totalNumberOfAllocations += 1;
-		totalAllocationSize += size;
-		totalNumberOfDeallocations += 1;
-		totalNumberOfMovingReallocs += 1;
+		countMovingReallocation (size);
 	} else {
-		totalNumberOfReallocsInSitu += 1;
+		countReallocationInSitu ();
 	}
 	return result;
 }
@@ -164,8 +253,7 @@ void * _Melder_calloc (int64 nelem, int64 elsize) {
 		Melder_throw (U"Out of memory: there is not enough room for ", Melder_bigInteger (nelem), U" more elements whose sizes are ", elsize, U" bytes each.");
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_calloc\t", Melder_pointer (result), U"\t", Melder_bigInteger (nelem), U"\t", Melder_bigInteger (elsize));
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += nelem * elsize;
+	countAllocation (nelem * elsize);
 	return result;
 }
 
@@ -187,8 +275,7 @@ void * _Melder_calloc_f (int64 nelem, int64 elsize) {
 				U" more elements whose sizes are ", Melder_bigInteger (elsize), U" bytes each.");
 		}
 	}
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += nelem * elsize;
+	countAllocation (nelem * elsize);
 	return result;
 }
 
@@ -203,8 +290,7 @@ char * Melder_strdup (const char *string) {
 	strcpy (result, string);
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_strdup\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t", sizeof (char));
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	countAllocation (size);
 	return result;
 }
 
@@ -224,8 +310,7 @@ char * Melder_strdup_f (const char *string) {
 		}
 	}
 	strcpy (result, string);
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size;
+	countAllocation (size);
 	return result;
 }
 
@@ -240,8 +325,7 @@ char32 * Melder_dup (const char32 *string /* cattable */) {
 	str32cpy (result, string);
 	if (Melder_debug == 34)
 		Melder_casual (U"Melder_dup\t", Melder_pointer (result), U"\t", Melder_bigInteger (size), U"\t", sizeof (char32));
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size * (int64) sizeof (char32);
+	countAllocation (size * (int64) sizeof (char32));
 	return result;
 }
 
@@ -261,29 +345,28 @@ char32 * Melder_dup_f (const char32 *string /* cattable */) {
 		}
 	}
 	str32cpy (result, string);
-	totalNumberOfAllocations += 1;
-	totalAllocationSize += size * (int64) sizeof (char32);
+	countAllocation (size * (int64) sizeof (char32));
 	return result;
 }
 
 int64 Melder_allocationCount () {
-	return totalNumberOfAllocations;
+	return sumOverThreads (theNumberOfAllocationsInFinishedThreads, & MelderAllocationCounts::numberOfAllocations);
 }
 
 int64 Melder_deallocationCount () {
-	return totalNumberOfDeallocations;
+	return sumOverThreads (theNumberOfDeallocationsInFinishedThreads, & MelderAllocationCounts::numberOfDeallocations);
 }
 
 int64 Melder_allocationSize () {
-	return totalAllocationSize;
+	return sumOverThreads (theAllocationSizeInFinishedThreads, & MelderAllocationCounts::allocationSize);
 }
 
 int64 Melder_reallocationsInSituCount () {
-	return totalNumberOfReallocsInSitu;
+	return sumOverThreads (theNumberOfReallocsInSituInFinishedThreads, & MelderAllocationCounts::numberOfReallocsInSitu);
 }
 
 int64 Melder_movingReallocationsCount () {
-	return totalNumberOfMovingReallocs;
+	return sumOverThreads (theNumberOfMovingReallocsInFinishedThreads, & MelderAllocationCounts::numberOfMovingReallocs);
 }
 
 int Melder_cmp (const char32 *string1, const char32 *string2) {
@@ -83,6 +83,8 @@ the behaviour of Praat will temporarily change in the following ways:
 50: compute sum, mean, stdev with first-element offset (80 bits)
 51: compute sum, mean, stdev with two cycles, as in R (80 bits)
 (other numbers than 48-51: compute sum, mean, stdev with simple pairwise algorithm, base case 64 [80 bits])
+52: analyses and file reading that divide their work over threads use only one thread
+53: formulas on matrices and sounds are run cell by cell, never in blocks
 181: read and write native-endian real64
 900: use DG Meta Serif Science instead of Palatino
 1264: Mac: Sound_record_fixedTime uses microphone "FW Solo (1264)"
@@ -58,8 +58,11 @@
 	#include "macport_off.h"
 #endif
 #include <errno.h>
+#include <string>
+#include <vector>
 #include "abcio.h"
 #include "melder.h"
+#include "MelderThread.h"
 
 //#include "flac_FLAC_stream_encoder.h"
 extern "C" int  FLAC__stream_encoder_finish (FLAC__StreamEncoder *);
@@ -925,4 +928,163 @@ void MelderFile_close_nothrow (MelderFile me) {
 	_MelderFile_close (me, false);
 }
 
+/********** Reading many files with prefetching **********/
+
+/*
+	While the foreground (the calling thread) reads and decodes file number `currentFileNumber`,
+	a background thread reads at most `PREFETCH_LOOKAHEAD` files ahead into the file cache of the operating system,
+	and throws away what it reads. What it has read of the files that the foreground has not yet reached
+	is limited to `PREFETCH_MAXIMUM_NUMBER_OF_BYTES_AHEAD`, so that large files do not push each other out of the cache.
+	The background uses plain stdio on file names converted beforehand by the foreground (no Melder_throw, no static buffers);
+	a file that cannot be opened is skipped, because the foreground will find out about that itself.
+*/
+#define PREFETCH_LOOKAHEAD  4
+#define PREFETCH_MAXIMUM_NUMBER_OF_BYTES_AHEAD  (64 * 1024 * 1024)
+
+MelderThread_MUTEX (thePrefetchMutex);
+
+struct MelderFilePrefetchState {
+	std::vector <std::string> paths;   // in the file representation, converted by the foreground
+	std::vector <int64> numberOfBytesPrefetched;   // per file, only while the file is ahead of the foreground
+	std::vector <char> buffer;   // for the background, allocated by the foreground
+	int64 numberOfBytesAhead = 0;
+	integer currentFileNumber = 0;
+	bool stopping = false;
+};
+
+Thing_define (MelderFilePrefetch_Args, Thing) { public:
+	MelderFilePrefetchState *state;
+	integer numberOfFiles;
+	void (*readFile) (void *closure, integer ifile);
+	void *closure;
+	bool isForeground;
+};
+
+Thing_implement (MelderFilePrefetch_Args, Thing, 0);
+
+static autoMelderFilePrefetch_Args MelderFilePrefetch_Args_create (MelderFilePrefetchState *state, integer numberOfFiles,
+	void (*readFile) (void *closure, integer ifile), void *closure, bool isForeground)
+{
+	autoMelderFilePrefetch_Args me = Thing_new (MelderFilePrefetch_Args);
+	my state = state;
+	my numberOfFiles = numberOfFiles;
+	my readFile = readFile;
+	my closure = closure;
+	my isForeground = isForeground;
+	return me;
+}
+
+static void MelderFilePrefetchState_stop (MelderFilePrefetchState *me) {
+	MelderThread_LOCK (thePrefetchMutex);
+	my stopping = true;
+	MelderThread_UNLOCK (thePrefetchMutex);
+}
+
+/*
+	Waits until the background may read (more of) file `ifile`.
+	Returns false if the background should leave `ifile` alone, either because the foreground has reached it,
+	or because the foreground has finished (in which case `*stopping` becomes true).
+*/
+static bool MelderFilePrefetchState_waitForRoom (MelderFilePrefetchState *me, integer ifile, bool *stopping) {
+	for (;;) {
+		bool passed, room;
+		{
+			MelderThread_LOCK (thePrefetchMutex);
+			*stopping = my stopping;
+			passed = ( ifile <= my currentFileNumber );
+			room = ( ifile <= my currentFileNumber + PREFETCH_LOOKAHEAD && my numberOfBytesAhead < PREFETCH_MAXIMUM_NUMBER_OF_BYTES_AHEAD );
+			MelderThread_UNLOCK (thePrefetchMutex);
+		}
+		if (*stopping || passed) return false;
+		if (room) return true;
+		Melder_sleep (0.002);
+	}
+}
+
+static void MelderFilePrefetchState_addBytes (MelderFilePrefetchState *me, integer ifile, int64 numberOfBytes) {
+	MelderThread_LOCK (thePrefetchMutex);
+	if (ifile > my currentFileNumber) {
+		my numberOfBytesPrefetched [ifile - 1] += numberOfBytes;
+		my numberOfBytesAhead += numberOfBytes;
+	}
+	MelderThread_UNLOCK (thePrefetchMutex);
+}
+
+static MelderThread_RETURN_TYPE MelderFilePrefetch (MelderFilePrefetch_Args me) {
+	MelderFilePrefetchState *state = my state;
+	if (my isForeground) {
+		try {
+			for (integer ifile = 1; ifile <= my numberOfFiles; ifile ++) {
+				{
+					MelderThread_LOCK (thePrefetchMutex);
+					state -> currentFileNumber = ifile;
+					state -> numberOfBytesAhead -= state -> numberOfBytesPrefetched [ifile - 1];
+					MelderThread_UNLOCK (thePrefetchMutex);
+				}
+				my readFile (my closure, ifile);
+			}
+		} catch (MelderError) {
+			MelderFilePrefetchState_stop (state);   // before MelderThread_run waits for the background
+			throw;
+		}
+		MelderFilePrefetchState_stop (state);
+		MelderThread_RETURN;
+	}
+	for (integer ifile = 1; ifile <= my numberOfFiles; ifile ++) {
+		bool stopping;
+		if (! MelderFilePrefetchState_waitForRoom (state, ifile, & stopping)) {
+			if (stopping) MelderThread_RETURN;
+			continue;
+		}
+		FILE *f = fopen (state -> paths [ifile - 1]. c_str (), "rb");
+		if (! f) continue;
+		for (;;) {
+			size_t numberOfBytesRead = fread (state -> buffer. data (), 1, state -> buffer. size (), f);
+			if (numberOfBytesRead == 0) break;
+			MelderFilePrefetchState_addBytes (state, ifile, (int64) numberOfBytesRead);
+			if (numberOfBytesRead < state -> buffer. size () || ! MelderFilePrefetchState_waitForRoom (state, ifile, & stopping)) break;
+		}
+		fclose (f);
+		if (stopping) MelderThread_RETURN;
+	}
+	MelderThread_RETURN;
+}
+
+void Melder_readFilesWithPrefetching (integer numberOfFiles, const char32 * (*getPath) (void *closure, integer ifile),
+	void (*readFile) (void *closure, integer ifile), void *closure)
+{
+	bool prefetch = ( numberOfFiles >= 2 && MelderThread_getNumberOfProcessors () > 1 );
+	#if defined (_WIN32)
+		prefetch = false;   // stdio cannot open Unicode file names
+	#endif
+	MelderFilePrefetchState state;
+	if (prefetch) {
+		try {
+			state. paths. reserve ((size_t) numberOfFiles);
+			state. numberOfBytesPrefetched. assign ((size_t) numberOfFiles, 0);
+			state. buffer. resize (65536);
+			for (integer ifile = 1; ifile <= numberOfFiles; ifile ++) {
+				const char32 *path = getPath (closure, ifile);
+				char path8 [kMelder_MAXPATH+1];
+				if (str32len (path) > kMelder_MAXPATH / 4)   // no room for four bytes per character
+					path8 [0] = '\0';   // cannot be opened, so will be skipped
+				else
+					Melder_str32To8bitFileRepresentation_inplace (path, path8);
+				state. paths. push_back (std::string (path8));
+			}
+		} catch (std::bad_alloc&) {
+			prefetch = false;   // prefetching is an optimization only, so there is no need to complain
+		}
+	}
+	if (! prefetch) {
+		for (integer ifile = 1; ifile <= numberOfFiles; ifile ++)
+			readFile (closure, ifile);
+		return;
+	}
+	autoMelderFilePrefetch_Args args [2];
+	args [0] = MelderFilePrefetch_Args_create (& state, numberOfFiles, readFile, closure, false);
+	args [1] = MelderFilePrefetch_Args_create (& state, numberOfFiles, readFile, closure, true);   // the last one runs in this thread
+	MelderThread_run (MelderFilePrefetch, args, 2);
+}
+
 /* End of file melder_files.cpp */
@@ -138,10 +138,36 @@ const char32 * Melder_boolean (bool value) noexcept {
 /*@praat
 	assert string$ (1000000000000) = "1000000000000"
 	assert string$ (undefined) = "--undefined--"
+	assert string$ (0) = "0"
+	assert string$ (-0) = "-0"
+	assert string$ (1) = "1"
+	assert string$ (-1) = "-1"
+	assert string$ (999999999999999) = "999999999999999"
+	assert string$ (-123456789012345) = "-123456789012345"
+	assert string$ (1e15) = "1e+15"
+	assert string$ (-1e15) = "-1e+15"
+	assert string$ (123456789012345678) = "1.2345678901234568e+17"
+	assert string$ (0.1) = "0.1"
 @*/
 const char * Melder8_double (double value) noexcept {
 	if (isundef (value)) return "--undefined--";
 	if (++ ibuffer == NUMBER_OF_BUFFERS) ibuffer = 0;
+	if (fabs (value) < 1e15 && value == floor (value)) {
+		/*
+			Whole numbers below 10^15 are written by "%.15g" as plain integers, and read back exactly;
+			writing them digit by digit gives the same result without sprintf and strtod.
+		*/
+		char digits [16], *p = & digits [16], *q = buffers8 [ibuffer];
+		uint64 magnitude = (uint64) fabs (value);
+		do {
+			* -- p = (char) ('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (signbit (value)) * q ++ = '-';   // including "-0", as "%.15g" does
+		while (p < & digits [16]) * q ++ = * p ++;
+		*q = '\0';
+		return buffers8 [ibuffer];
+	}
 	sprintf (buffers8 [ibuffer], "%.15g", value);
 	if (strtod (buffers8 [ibuffer], nullptr) != value) {
 		sprintf (buffers8 [ibuffer], "%.16g", value);
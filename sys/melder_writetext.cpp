@@ -223,32 +223,49 @@ static void _MelderFile_write (MelderFile file, const char32 *string) {
 	if (! string) return;
 	int64 length = str32len (string);
 	FILE *f = file -> filePointer;
+	/*
+		The 8-bit encodings are collected in a local buffer and handed to stdio in one go,
+		because a putc per character costs a lock on many systems.
+	*/
+	const int bufferSize = 1024;
+	char buffer [bufferSize];
+	int n = 0;
 	if (file -> outputEncoding == kMelder_textOutputEncoding_ASCII || file -> outputEncoding == kMelder_textOutputEncoding_ISO_LATIN1) {
 		for (int64 i = 0; i < length; i ++) {
+			if (n > bufferSize - 2) {
+				fwrite (buffer, 1, (size_t) n, f);
+				n = 0;
+			}
 			char kar = (char) (char8) string [i];   // truncate
-			if (kar == '\n' && file -> requiresCRLF) putc (13, f);
-			putc (kar, f);
+			if (kar == '\n' && file -> requiresCRLF) buffer [n ++] = 13;
+			buffer [n ++] = kar;
 		}
+		fwrite (buffer, 1, (size_t) n, f);
 	} else if (file -> outputEncoding == (unsigned long) kMelder_textOutputEncoding::UTF8) {
 		for (int64 i = 0; i < length; i ++) {
+			if (n > bufferSize - 4) {
+				fwrite (buffer, 1, (size_t) n, f);
+				n = 0;
+			}
 			char32 kar = string [i];
 			if (kar <= 0x00007F) {
-				if (kar == U'\n' && file -> requiresCRLF) putc (13, f);
-				putc ((int) kar, f);   // guarded conversion down
+				if (kar == U'\n' && file -> requiresCRLF) buffer [n ++] = 13;
+				buffer [n ++] = (char) kar;   // guarded conversion down
 			} else if (kar <= 0x0007FF) {
-				putc (0xC0 | (kar >> 6), f);
-				putc (0x80 | (kar & 0x00003F), f);
+				buffer [n ++] = (char) (0xC0 | (kar >> 6));
+				buffer [n ++] = (char) (0x80 | (kar & 0x00003F));
 			} else if (kar <= 0x00FFFF) {
-				putc (0xE0 | (kar >> 12), f);
-				putc (0x80 | ((kar >> 6) & 0x00003F), f);
-				putc (0x80 | (kar & 0x00003F), f);
+				buffer [n ++] = (char) (0xE0 | (kar >> 12));
+				buffer [n ++] = (char) (0x80 | ((kar >> 6) & 0x00003F));
+				buffer [n ++] = (char) (0x80 | (kar & 0x00003F));
 			} else {
-				putc (0xF0 | (kar >> 18), f);
-				putc (0x80 | ((kar >> 12) & 0x00003F), f);
-				putc (0x80 | ((kar >> 6) & 0x00003F), f);
-				putc (0x80 | (kar & 0x00003F), f);
+				buffer [n ++] = (char) (0xF0 | (kar >> 18));
+				buffer [n ++] = (char) (0x80 | ((kar >> 12) & 0x00003F));
+				buffer [n ++] = (char) (0x80 | ((kar >> 6) & 0x00003F));
+				buffer [n ++] = (char) (0x80 | (kar & 0x00003F));
 			}
 		}
+		fwrite (buffer, 1, (size_t) n, f);
 	} else {
 		for (int64 i = 0; i < length; i ++) {
 			char32 kar = string [i];
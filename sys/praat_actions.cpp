@@ -23,10 +23,42 @@
 #include "machine.h"
 #include "GuiP.h"
 
+#include <string>
+#include <unordered_map>
+
 #define BUTTON_LEFT  -240
 #define BUTTON_RIGHT -5
 
 static OrderedOf <structPraat_Command> theActions;
+
+/*
+	An index from the title of an action to its first position in theActions;
+	further actions with the same title (i.e. for different selections) are chained in order of position.
+	Every change in theActions invalidates the index, which is rebuilt the next time it is needed.
+*/
+static std::unordered_map <std::u32string, integer> theActionsByTitle;
+static autoNUMvector <integer> theNextActionWithSameTitle;   // 0 means: no further action with this title
+static bool theActionsIndexIsValid = false;
+
+static void indexActions () {
+	if (theActionsIndexIsValid) return;
+	theActionsByTitle. clear ();
+	theNextActionWithSameTitle. reset (0, theActions.size);
+	for (integer i = theActions.size; i >= 1; i --) {
+		const char32 *title = theActions.at [i] -> title;
+		if (! title) continue;   // a separator
+		integer& first = theActionsByTitle [title];   // 0 if new
+		theNextActionWithSameTitle [i] = first;
+		first = i;
+	}
+	theActionsIndexIsValid = true;
+}
+
+static integer firstActionWithTitle (const char32 *title) {
+	indexActions ();
+	auto it = theActionsByTitle. find (title);
+	return it == theActionsByTitle. end () ? 0 : it -> second;
+}
 static GuiMenu praat_writeMenu;
 static GuiMenuItem praat_writeMenuSeparator;
 static GuiForm praat_form;
@@ -73,11 +105,24 @@ static integer lookUpMatchingAction (ClassInfo class1, ClassInfo class2, ClassIn
  * Precondition:
  *	class1, class2, and class3 must be in sorted order.
  */
+	if (! title) return 0;
+	if (theActionsIndexIsValid) {
+		for (integer i = firstActionWithTitle (title); i != 0; i = theNextActionWithSameTitle [i]) {
+			Praat_Command action = theActions.at [i];
+			if (class1 == action -> class1 && class2 == action -> class2 &&
+			    class3 == action -> class3 && class4 == action -> class4) return i;
+		}
+		return 0;   // not found
+	}
+	/*
+		While the actions are being added (at start-up), the index would have to be rebuilt at every call,
+		so a linear search is faster.
+	*/
 	for (integer i = 1; i <= theActions.size; i ++) {
 		Praat_Command action = theActions.at [i];
 		if (class1 == action -> class1 && class2 == action -> class2 &&
 		    class3 == action -> class3 && class4 == action -> class4 &&
-		    title && action -> title && str32equ (action -> title, title)) return i;
+		    action -> title && str32equ (action -> title, title)) return i;
 	}
 	return 0;   // not found
 }
@@ -161,6 +206,7 @@ void praat_addAction4_ (ClassInfo class1, integer n1, ClassInfo class2, integer
 		 * Insert new command.
 		 */
 		theActions. addItemAtPosition_move (action.move(), position);
+		theActionsIndexIsValid = false;
 	} catch (MelderError) {
 		Melder_flushError ();
 	}
@@ -249,6 +295,7 @@ void praat_addActionScript (const char32 *className1, integer n1, const char32 *
 			integer found = lookUpMatchingAction (class1, class2, class3, nullptr, title);
 			if (found) {
 				theActions. removeItem (found);
+				theActionsIndexIsValid = false;
 			}
 		}
 
@@ -299,6 +346,7 @@ void praat_addActionScript (const char32 *className1, integer n1, const char32 *
 		 * Insert new command.
 		 */
 		theActions. addItemAtPosition_move (action.move(), position);
+		theActionsIndexIsValid = false;
 		updateDynamicMenu ();
 	} catch (MelderError) {
 		Melder_throw (U"Praat: script action not added.");
@@ -317,6 +365,7 @@ void praat_removeAction (ClassInfo class1, ClassInfo class2, ClassInfo class3, c
 				U": ", title, U"\" not found.");
 		}
 		theActions. removeItem (found);
+		theActionsIndexIsValid = false;
 	} catch (MelderError) {
 		Melder_throw (U"Praat: action not removed.");
 	}
@@ -455,6 +504,7 @@ void praat_sortActions () {
 		action -> sortingTail = i;
 	}
 	qsort (& theActions.at [1], theActions.size, sizeof (Praat_Command), compareActions);
+	theActionsIndexIsValid = false;
 }
 
 static const char32 *numberString (int number) {
@@ -714,17 +764,17 @@ void praat_saveToggledActions (MelderString *buffer) {
 }
 
 int praat_doAction (const char32 *command, const char32 *arguments, Interpreter interpreter) {
-	integer i = 1;
-	while (i <= theActions.size && (! theActions.at [i] -> executable || str32cmp (theActions.at [i] -> title, command))) i ++;
-	if (i > theActions.size) return 0;   // not found
+	integer i = firstActionWithTitle (command);
+	while (i != 0 && ! theActions.at [i] -> executable) i = theNextActionWithSameTitle [i];
+	if (i == 0) return 0;   // not found
 	theActions.at [i] -> callback (nullptr, 0, nullptr, arguments, interpreter, command, false, nullptr);
 	return 1;
 }
 
 int praat_doAction (const char32 *command, integer narg, Stackel args, Interpreter interpreter) {
-	integer i = 1;
-	while (i <= theActions.size && (! theActions.at [i] -> executable || str32cmp (theActions.at [i] -> title, command))) i ++;
-	if (i > theActions.size) return 0;   // not found
+	integer i = firstActionWithTitle (command);
+	while (i != 0 && ! theActions.at [i] -> executable) i = theNextActionWithSameTitle [i];
+	if (i == 0) return 0;   // not found
 	theActions.at [i] -> callback (nullptr, narg, args, nullptr, interpreter, command, false, nullptr);
 	return 1;
 }
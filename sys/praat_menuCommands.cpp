@@ -21,8 +21,40 @@
 #include "praat_version.h"
 #include "GuiP.h"
 
+#include <string>
+#include <unordered_map>
+
 static OrderedOf <structPraat_Command> theCommands;
 
+/*
+	An index from the title of a menu command to its first position in theCommands;
+	further commands with the same title (i.e. in other windows or menus) are chained in order of position.
+	Every change in theCommands invalidates the index, which is rebuilt the next time it is needed.
+*/
+static std::unordered_map <std::u32string, integer> theCommandsByTitle;
+static autoNUMvector <integer> theNextCommandWithSameTitle;   // 0 means: no further command with this title
+static bool theCommandsIndexIsValid = false;
+
+static void indexMenuCommands () {
+	if (theCommandsIndexIsValid) return;
+	theCommandsByTitle. clear ();
+	theNextCommandWithSameTitle. reset (0, theCommands.size);
+	for (integer i = theCommands.size; i >= 1; i --) {
+		const char32 *title = theCommands.at [i] -> title;
+		if (! title) continue;   // a separator
+		integer& first = theCommandsByTitle [title];   // 0 if new
+		theNextCommandWithSameTitle [i] = first;
+		first = i;
+	}
+	theCommandsIndexIsValid = true;
+}
+
+static integer firstMenuCommandWithTitle (const char32 *title) {
+	indexMenuCommands ();
+	auto it = theCommandsByTitle. find (title);
+	return it == theCommandsByTitle. end () ? 0 : it -> second;
+}
+
 void praat_menuCommands_init () {
 }
 
@@ -48,12 +80,27 @@ void praat_sortMenuCommands () {
 		command -> sortingTail = i;
 	}
 	qsort (& theCommands.at [1], theCommands.size, sizeof (Praat_Command), compareMenuCommands);
+	theCommandsIndexIsValid = false;
 }
 
 static integer lookUpMatchingMenuCommand (const char32 *window, const char32 *menu, const char32 *title) {
 /*
  * A menu command is fully specified by its environment (window + menu) and its title.
  */
+	if (theCommandsIndexIsValid && title) {
+		for (integer i = firstMenuCommandWithTitle (title); i != 0; i = theNextCommandWithSameTitle [i]) {
+			Praat_Command command = theCommands.at [i];
+			const char32 *tryWindow = command -> window;
+			const char32 *tryMenu = command -> menu;
+			if ((window == tryWindow || (window && tryWindow && str32equ (window, tryWindow))) &&
+			    (menu == tryMenu || (menu && tryMenu && str32equ (menu, tryMenu)))) return i;
+		}
+		return 0;   // not found
+	}
+	/*
+		While the commands are being added (at start-up), the index would have to be rebuilt at every call,
+		so a linear search is faster.
+	*/
 	for (integer i = 1; i <= theCommands.size; i ++) {
 		Praat_Command command = theCommands.at [i];
 		const char32 *tryWindow = command -> window;
@@ -225,6 +272,7 @@ GuiMenuItem praat_addMenuCommand_ (const char32 *window, const char32 *menu, con
 	}
 	Thing_cast (GuiMenuItem, button_as_GuiMenuItem, command -> button);
 	theCommands. addItemAtPosition_move (command.move(), position);
+	theCommandsIndexIsValid = false;
 	return button_as_GuiMenuItem;
 }
 
@@ -316,6 +364,7 @@ void praat_addMenuCommandScript (const char32 *window, const char32 *menu, const
 			}
 		}
 		theCommands. addItemAtPosition_move (command.move(), position);
+		theCommandsIndexIsValid = false;
 
 		if (praatP.phase >= praat_HANDLING_EVENTS) praat_sortMenuCommands ();
 	} catch (MelderError) {
@@ -399,6 +448,7 @@ void praat_addFixedButtonCommand_ (GuiForm parent, const char32 *title, UiCallba
 	}
 	my executable = false;
 	theCommands. addItemAtPosition_move (me.move(), 0);
+	theCommandsIndexIsValid = false;
 }
 
 void praat_sensitivizeFixedButtonCommand (const char32 *title, int sensitive) {
@@ -418,9 +468,9 @@ void praat_sensitivizeFixedButtonCommand (const char32 *title, int sensitive) {
 
 int praat_doMenuCommand (const char32 *title, const char32 *arguments, Interpreter interpreter) {
 	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
+	for (integer i = firstMenuCommandWithTitle (title); i != 0; i = theNextCommandWithSameTitle [i]) {
 		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title, title) &&
+		if (command -> executable &&
 			(str32equ (command -> window, U"Objects") || str32equ (command -> window, U"Picture")))
 		{
 			commandFound = command;
@@ -434,9 +484,9 @@ int praat_doMenuCommand (const char32 *title, const char32 *arguments, Interpret
 
 int praat_doMenuCommand (const char32 *title, integer narg, Stackel args, Interpreter interpreter) {
 	Praat_Command commandFound = nullptr;
-	for (integer i = 1; i <= theCommands.size; i ++) {
+	for (integer i = firstMenuCommandWithTitle (title); i != 0; i = theNextCommandWithSameTitle [i]) {
 		Praat_Command command = theCommands.at [i];
-		if (command -> executable && str32equ (command -> title, title) &&
+		if (command -> executable &&
 			(str32equ (command -> window, U"Objects") || str32equ (command -> window, U"Picture")))
 		{
 			commandFound = command;